@@ -7,26 +7,22 @@
 // Local Includes
 #include "starlyze.cpp" 
 
-void PlotPairInvMass(const std::string& result_file_path = "slight.out") {
-    // Read inn result
-    const SimulationResult results = ReadSimulationResults(result_file_path);
-
-    // Create ROOT output file before any plotting
-    const std::string base_file_name = results.decay_repr_str 
-                                     + std::string("_") + std::to_string(results.n_events)
-                                     + std::string("_") + std::to_string(results.rnd_seed)
-                                     + std::string("_pair_inv_mass");
-    const std::string root_file_name = base_file_name + std::string(".root");
-    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+// Returns finished pair invariant mass histogram, its peak, 
+// and the mixed event background if chosen
+CachedResult AnalysePairInvMass(const std::string& result_file_path, 
+                                const bool& bayesian_blocks,
+                                const bool& event_mixing) {
+    // Read inn result, keeping the tracks of each event for event mixing
+    const SimulationResult results = ReadSimulationResults(result_file_path, event_mixing);
 
     // Create title for plot
     const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s", 
                              results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
 
     // Create list of all pair invariant masses
-    std::vector<double> m_inv_pairs_list;
+    std::vector<Real> m_inv_pairs_list;
     for (const Event& event : results.events) {
-        for (const double& m_inv_pair : event.m_inv_pairs) {
+        for (const Real& m_inv_pair : event.m_inv_pairs) {
             m_inv_pairs_list.push_back(m_inv_pair);
         }
     }
@@ -39,14 +35,45 @@ void PlotPairInvMass(const std::string& result_file_path = "slight.out") {
     const double bin_width = FreedmanDiaconisBinWidth(m_inv_pairs_list);
     const int n_bins = (max - min)/bin_width;
 
-    // Create histogram object
-    TH1D* hist = new TH1D("hist", title, n_bins, min, max);
+    // Create histogram object, with variable width Bayesian Blocks bins if chosen
+    TH1D* hist;
+    if (bayesian_blocks) {
+        const std::vector<double> bin_edges = BayesianBlocksBinEdges(m_inv_pairs_list);
+        hist = new TH1D("hist", title, bin_edges.size() - 1, bin_edges.data());
+    } else {
+        hist = new TH1D("hist", title, n_bins, min, max);
+    }
 
     // Fill histograms
-    for (const double& pair_inv_mass : m_inv_pairs_list) {
+    for (const Real& pair_inv_mass : m_inv_pairs_list) {
         hist->Fill(pair_inv_mass);
     }
 
+    // Estimate uncorrelated background by event mixing, with the same binning
+    TH1D* background = (TH1D*)hist->Clone("background");
+    if (event_mixing) {
+        std::vector<double> bin_edges;
+        for (int i = 1; i <= hist->GetNbinsX() + 1; i++) {
+            bin_edges.push_back(hist->GetXaxis()->GetBinLowEdge(i));
+        }
+        const std::vector<double> background_counts = MixedEventPairInvMassCounts(results.events, 
+                                                                                  bin_edges);
+        for (int i = 1; i <= hist->GetNbinsX(); i++) {
+            background->SetBinContent(i, background_counts[i-1]);
+        }
+
+        // Normalize background to the same amount of pairs, if any were mixed
+        if (background->Integral() > 0) {
+            background->Scale(hist->Integral() / background->Integral());
+        }
+    }
+
+    // Variable width bins are compared by counts per unit on the x-axis
+    if (bayesian_blocks) {
+        hist->Scale(1.0/1000, "width");
+        background->Scale(1.0/1000, "width");
+    }
+
     // Calculate invariant mass peak and its FWHM
     const int bin_max = hist->GetMaximumBin();
     const double hist_peak = hist->GetXaxis()->GetBinCenter(bin_max);
@@ -58,8 +85,67 @@ void PlotPairInvMass(const std::string& result_file_path = "slight.out") {
     const double fwhm = hist->GetXaxis()->GetBinCenter(fwhm_right) 
                       - hist->GetXaxis()->GetBinCenter(fwhm_left);
 
+    // Store everything needed for plotting
+    CachedResult analysis;
+    analysis.base_file_name = results.decay_repr_str 
+                            + std::string("_") + std::to_string(results.n_events)
+                            + std::string("_") + std::to_string(results.rnd_seed)
+                            + std::string("_pair_inv_mass");
+    analysis.title = title;
+    analysis.n_events = results.n_events;
+    for (int i = 1; i <= hist->GetNbinsX() + 1; i++) {
+        analysis.bin_edges.push_back(hist->GetXaxis()->GetBinLowEdge(i));
+    }
+    for (int i = 1; i <= hist->GetNbinsX(); i++) {
+        analysis.bin_contents["hist"].push_back(hist->GetBinContent(i));
+        if (event_mixing) {
+            analysis.bin_contents["background"].push_back(background->GetBinContent(i));
+        }
+    }
+    analysis.summary["peak"] = hist_peak;
+    analysis.summary["bin_width"] = bin_width;
+
+    delete hist;
+    delete background;
+    return analysis;
+}
+
+void PlotPairInvMass(const std::string& result_file_path = "slight.out",
+                     const bool& bayesian_blocks = false,
+                     const bool& event_mixing = false) {
+    // Reuse finished analysis if input and settings are unchanged since last run
+    const std::string cache_key = ResultCacheKey(result_file_path, 
+                                                 Form("PlotPairInvMass %i %i", bayesian_blocks, event_mixing));
+    const std::vector<std::string> histogram_names = event_mixing ? std::vector<std::string>{"hist", "background"}
+                                                                  : std::vector<std::string>{"hist"};
+    CachedResult analysis;
+    if (!LoadCachedResult(cache_key, analysis, histogram_names)) {
+        analysis = AnalysePairInvMass(result_file_path, bayesian_blocks, event_mixing);
+        StoreCachedResult(cache_key, analysis);
+    }
+
+    // Create ROOT output file before any plotting
+    const std::string base_file_name = analysis.base_file_name;
+    const std::string root_file_name = base_file_name + std::string(".root");
+    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+
+    // Create histogram objects from finished analysis
+    const std::vector<double>& bin_contents = analysis.bin_contents["hist"];
+    TH1D* hist = new TH1D("hist", analysis.title.c_str(), bin_contents.size(), 
+                          analysis.bin_edges.data());
+    TH1D* background = new TH1D("background", analysis.title.c_str(), bin_contents.size(), 
+                                analysis.bin_edges.data());
+    for (std::size_t i = 0; i < bin_contents.size(); i++) {
+        hist->SetBinContent(i + 1, bin_contents[i]);
+        if (event_mixing) {
+            background->SetBinContent(i + 1, analysis.bin_contents["background"][i]);
+        }
+    }
+    const double hist_peak = analysis.summary["peak"];
+    const double bin_width = analysis.summary["bin_width"];
+
     // Text information about amount of events
-    const char* events_info = Form("\\text{%i events}", results.n_events);
+    const char* events_info = Form("\\text{%i events}", analysis.n_events);
     TLatex* events_info_text = new TLatex(0.54, 0.80, events_info);
     events_info_text->SetNDC();
 
@@ -68,13 +154,22 @@ void PlotPairInvMass(const std::string& result_file_path = "slight.out") {
     TLatex* peak_info_text = new TLatex(0.54, 0.75, peak_info);
     peak_info_text->SetNDC();
 
+    // Text information about mixed event background
+    TLatex* background_info_text = new TLatex(0.54, 0.70, "\\text{Mixed event background}");
+    background_info_text->SetNDC();
+    background_info_text->SetTextColor(kRed);
+
     // Create a canvas to draw on
     TCanvas* canvas = new TCanvas("canvas", "", 900, 700);
 
     // Draw histograms and info texts
     hist->SetStats(kFALSE);
     hist->SetXTitle("\\text{2 Particle Invariant Mass [GeV/c}^{2}\\text{]}");
-    hist->SetYTitle(Form("\\text{Counts per %.2f [MeV/c}^{2}\\text{]}", bin_width*1000));
+    if (bayesian_blocks) {
+        hist->SetYTitle("\\text{Counts per MeV/c}^{2}");
+    } else {
+        hist->SetYTitle(Form("\\text{Counts per %.2f [MeV/c}^{2}\\text{]}", bin_width*1000));
+    }
     hist->GetXaxis()->CenterTitle();
     hist->GetYaxis()->CenterTitle();
     hist->GetXaxis()->SetTitleOffset(1.0);
@@ -88,6 +183,13 @@ void PlotPairInvMass(const std::string& result_file_path = "slight.out") {
     hist->Draw();
     events_info_text->Draw();
     peak_info_text->Draw();
+    if (event_mixing) {
+        background->SetLineColor(kRed);
+        background->SetLineWidth(2);
+        background->SetFillColor(0);
+        background->Draw("HIST SAME");
+        background_info_text->Draw();
+    }
 
     // Save plot to TEX file
     const std::string tex_file_name = base_file_name + std::string(".tex");
@@ -13,6 +13,23 @@ void PlotPairInvMass2D(const std::string& result_file_path = "slight.out") {
     // Read inn result
     const SimulationResult results = ReadSimulationResults(result_file_path);
 
+    // Pair invariant masses of events with two particle pairs
+    std::vector<Real> m_inv_pairs_1;
+    std::vector<Real> m_inv_pairs_2;
+    std::vector<std::array<Real, 2>> m_inv_pairs_points;
+    for (const Event& event : results.events) {
+        if (event.m_inv_pairs.size() != 2) continue;
+        m_inv_pairs_1.push_back(event.m_inv_pairs[0]);
+        m_inv_pairs_2.push_back(event.m_inv_pairs[1]);
+        m_inv_pairs_points.push_back({event.m_inv_pairs[0], event.m_inv_pairs[1]});
+    }
+
+    // Two-body decays have only one pair per event
+    if (m_inv_pairs_points.empty()) {
+        std::cout << "No events with two particle pairs in " << result_file_path << std::endl;
+        return;
+    }
+
     // Create ROOT output file before any plotting
     const std::string base_file_name = results.decay_repr_str 
                                      + std::string("_") + std::to_string(results.n_events)
@@ -25,38 +42,44 @@ void PlotPairInvMass2D(const std::string& result_file_path = "slight.out") {
     const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s", 
                              results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
 
-    // Seperate particle pairs invariant masses
-    std::vector<double> m_inv_pairs_1;
-    std::vector<double> m_inv_pairs_2;
-    for (const Event& event : results.events) {
-        m_inv_pairs_1.push_back(event.m_inv_pairs[0]);
-        m_inv_pairs_2.push_back(event.m_inv_pairs[1]);
-    }
-
-    // Create pair inv mass vs pair inv mass histogram
+    // Create sparse pair inv mass vs pair inv mass histogram
     const double min_1 = std::min_element(m_inv_pairs_1.begin(), m_inv_pairs_1.end())[0];
-    const double max_1 = std::max_element(m_inv_pairs_1.begin(), m_inv_pairs_1.end())[0];
-    const double width_1 = FreedmanDiaconisBinWidth(m_inv_pairs_1);
-    const int nbins_1 = (max_1 - min_1)/width_1;
+    const double width_1 = SparseBinWidth(m_inv_pairs_1);
 
     const double min_2 = std::min_element(m_inv_pairs_2.begin(), m_inv_pairs_2.end())[0];
-    const double max_2 = std::max_element(m_inv_pairs_2.begin(), m_inv_pairs_2.end())[0];
-    const double width_2 = FreedmanDiaconisBinWidth(m_inv_pairs_2);
-    const int nbins_2 = (max_2 - min_2)/width_2;
+    const double width_2 = SparseBinWidth(m_inv_pairs_2);
 
-    // Create histogram object
-    TH2D* hist = new TH2D("hist", title, nbins_1, min_1, max_1, 
-                                         nbins_2, min_2, max_2);
+    SparseHistogram<2> sparse_hist({min_1, min_2}, {width_1, width_2});
 
-    // Fill histogram
-    for (int i=0; i < results.n_events/2; i++) {
-        hist->Fill(m_inv_pairs_1[i], m_inv_pairs_2[i]);
-    }
+    // Fill sparse histogram
+    sparse_hist.FillParallel(m_inv_pairs_points);
 
     // Get peak
-    const int bin_max = hist->GetMaximumBin();
-    const double hist_peak = hist->GetYaxis()->GetBinCenter(bin_max);
-    std::cout << hist_peak;
+    std::uint64_t peak_key = 0;
+    double peak_count = 0;
+    for (const auto& bin : sparse_hist.bins) {
+        if (bin.second > peak_count) {
+            peak_key = bin.first;
+            peak_count = bin.second;
+        }
+    }
+    const std::array<std::uint64_t, 2> peak_indices = sparse_hist.BinIndices(peak_key);
+    std::cout << sparse_hist.BinCenter(0, peak_indices[0]) << " " 
+              << sparse_hist.BinCenter(1, peak_indices[1]) << std::endl;
+
+    // Create histogram object covering the occupied bins for drawing,
+    // with bins merged so the dense copy stays small
+    const SparseHistogram<2> drawn_hist = sparse_hist.Rebinned(kSPARSE_MAX_DRAWN_BINS);
+    const int nbins_1 = drawn_hist.NumBins(0);
+    const int nbins_2 = drawn_hist.NumBins(1);
+    const double drawn_width_1 = drawn_hist.bin_widths[0];
+    const double drawn_width_2 = drawn_hist.bin_widths[1];
+    TH2D* hist = new TH2D("hist", title, nbins_1, min_1, min_1 + nbins_1*drawn_width_1, 
+                                         nbins_2, min_2, min_2 + nbins_2*drawn_width_2);
+    for (const auto& bin : drawn_hist.bins) {
+        const std::array<std::uint64_t, 2> indices = drawn_hist.BinIndices(bin.first);
+        hist->SetBinContent(indices[0] + 1, indices[1] + 1, bin.second);
+    }
 
     // Text information about amount of events
     const char* events_info = Form("\\text{%i events}", results.n_events);
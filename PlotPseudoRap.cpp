@@ -10,44 +10,72 @@
 
 static constexpr double kPSEUDO_RAP_ACCEPT = 0.9;
 
-void PlotPseudoRap(const std::string& result_file_path = "slight.out") {
-    // Read inn result
-    const SimulationResult results = ReadSimulationResults(result_file_path);
-
-    // Create ROOT output file before any plotting
-    const std::string base_file_name = results.decay_repr_str 
-                                     + std::string("_") + std::to_string(results.n_events)
-                                     + std::string("_") + std::to_string(results.rnd_seed)
-                                     + std::string("_pseudo_rap");
-    const std::string root_file_name = base_file_name + std::string(".root");
-    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
-
-    // Create title for plot
-    const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s; \\text{Event number}; \\text{Particles Detected}", 
-                             results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
-    
-    // Create bar chart values
-    std::string bar_str[5] = {"0","1","2","3","4"};
-    int bar_val[5] = {0, 0, 0, 0, 0};;
-    int particles_detected = 0;
-    for (const Event& event : results.events) {
+// Returns finished bar chart of detected particles per event
+CachedResult AnalysePseudoRap(const std::string& result_file_path) {
+    // Stream inn result, counting the events with each number of detected particles
+    int bar_val[5] = {0, 0, 0, 0, 0};
+    const SimulationResult results = StreamSimulationResults(result_file_path, [&](Event& event) {
         // Count detected particles in event
-        particles_detected = 0;
-        for (const double& pseudo_rap : event.pseudo_raps) {
+        int particles_detected = 0;
+        for (const Real& pseudo_rap : event.pseudo_raps) {
             if (-kPSEUDO_RAP_ACCEPT < pseudo_rap && pseudo_rap < kPSEUDO_RAP_ACCEPT) {
                 particles_detected +=1;
             }
         }
-        // Add particles detected to bar chart and check if event was detected
+        // Add particles detected to bar chart
         if (particles_detected == 0) {bar_val[0] += 1;}
         if (particles_detected == 1) {bar_val[1] += 1;}
         if (particles_detected == 2) {bar_val[2] += 1;}
         if (particles_detected == 3) {bar_val[3] += 1;}
         if (particles_detected == 4) {bar_val[4] += 1;}
+    });
+
+    // Create title for plot
+    const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s; \\text{Event number}; \\text{Particles Detected}", 
+                             results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
+
+    // Store everything needed for plotting
+    CachedResult analysis;
+    analysis.base_file_name = results.decay_repr_str 
+                            + std::string("_") + std::to_string(results.n_events)
+                            + std::string("_") + std::to_string(results.rnd_seed)
+                            + std::string("_pseudo_rap");
+    analysis.title = title;
+    analysis.n_events = results.n_events;
+    for (int i = 0; i < 6; i++) {
+        analysis.bin_edges.push_back(i);
+    }
+    for (int i = 0; i < 5; i++) {
+        analysis.bin_contents["hist"].push_back(bar_val[i]);
+    }
+
+    return analysis;
+}
+
+void PlotPseudoRap(const std::string& result_file_path = "slight.out") {
+    // Reuse finished analysis if input and acceptance are unchanged since last run
+    const std::string cache_key = ResultCacheKey(result_file_path, 
+                                                 Form("PlotPseudoRap %.17g", kPSEUDO_RAP_ACCEPT));
+    CachedResult analysis;
+    if (!LoadCachedResult(cache_key, analysis)) {
+        analysis = AnalysePseudoRap(result_file_path);
+        StoreCachedResult(cache_key, analysis);
+    }
+
+    // Create ROOT output file before any plotting
+    const std::string base_file_name = analysis.base_file_name;
+    const std::string root_file_name = base_file_name + std::string(".root");
+    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+
+    // Create bar chart values from finished analysis
+    std::string bar_str[5] = {"0","1","2","3","4"};
+    int bar_val[5];
+    for (int i = 0; i < 5; i++) {
+        bar_val[i] = analysis.bin_contents["hist"][i];
     }
 
     // Create histogram to become barchart
-    TH1D* bar = new TH1D("bar",title,5,0,5);
+    TH1D* bar = new TH1D("bar",analysis.title.c_str(),5,0,5);
 
     // Fill bar chart
     for (int i=1; i<6; i++) {
@@ -56,7 +84,7 @@ void PlotPseudoRap(const std::string& result_file_path = "slight.out") {
      }
 
     // Text information about amount of events
-    const char* events_info = Form("\\text{%i events}", results.n_events);
+    const char* events_info = Form("\\text{%i events}", analysis.n_events);
     TLatex* events_info_text = new TLatex(0.54, 0.80, events_info);
     events_info_text->SetNDC();
 
@@ -0,0 +1,105 @@
+// ROOT Includes
+#include "TH2D.h"
+#include "TGraph.h"
+#include "TCanvas.h"
+#include "TLatex.h"
+#include "TColor.h"
+#include "TFile.h"
+
+// Local Includes
+#include "starlyze.cpp"
+
+void PlotPseudoRapScan(const std::string& result_file_path = "slight.out",
+                       const double& max_pseudo_rap_accept = 4.0,
+                       const int& n_cuts = 4000) {
+    // Acceptance cuts at the bin centers of the scan histogram
+    const double cut_width = max_pseudo_rap_accept / n_cuts;
+    std::vector<double> cuts;
+    for (int k = 0; k < n_cuts; k++) {
+        cuts.push_back((k + 0.5) * cut_width);
+    }
+
+    // Stream inn result, counting particles detected in every event for all cuts
+    AcceptanceScanner scanner(cuts);
+    const SimulationResult results = StreamSimulationResults(result_file_path, 
+        [&](Event& event) { scanner.Add(event.pseudo_raps); });
+    const AcceptanceScan scan = scanner.Scan();
+    const int n_detected_max = scan.detected_counts.size() - 1;
+
+    // Create ROOT output file before any plotting
+    const std::string base_file_name = results.decay_repr_str
+                                     + std::string("_") + std::to_string(results.n_events)
+                                     + std::string("_") + std::to_string(results.rnd_seed)
+                                     + std::string("_pseudo_rap_scan");
+    const std::string root_file_name = base_file_name + std::string(".root");
+    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+
+    // Create title for plot
+    const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s",
+                             results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
+
+    // Create histogram of events per particles detected against cut
+    TH2D* hist = new TH2D("hist", title, n_cuts, 0, max_pseudo_rap_accept,
+                                         n_detected_max + 1, 0, n_detected_max + 1);
+    for (int n = 0; n <= n_detected_max; n++) {
+        for (int k = 0; k < n_cuts; k++) {
+            hist->SetBinContent(k + 1, n + 1, scan.detected_counts[n][k]);
+        }
+        hist->GetYaxis()->SetBinLabel(n + 1, std::to_string(n).c_str());
+    }
+
+    // Create curve of full detection efficiency against cut, which is 0 without events
+    std::vector<double> efficiencies;
+    for (const double& full_detection_count : scan.full_detection_counts) {
+        efficiencies.push_back((results.n_events > 0) ? full_detection_count / results.n_events : 0);
+    }
+    TGraph* efficiency = new TGraph(n_cuts, cuts.data(), efficiencies.data());
+    efficiency->SetName("efficiency");
+    efficiency->SetTitle(title);
+
+    // Text information about amount of events
+    const char* events_info = Form("\\text{%i events}", results.n_events);
+    TLatex* events_info_text = new TLatex(0.54, 0.80, events_info);
+    events_info_text->SetNDC();
+
+    // Create a canvas to draw on
+    TCanvas* canvas = new TCanvas("canvas", "", 1800, 700);
+    canvas->Divide(2, 1);
+
+    // Change color pallete
+    gStyle->SetPalette(kDeepSea);
+
+    // Draw histogram, efficiency curve and info texts
+    canvas->cd(1);
+    hist->SetStats(kFALSE);
+    hist->SetXTitle("\\text{Acceptance } |\\eta| \\text{ cut}");
+    hist->SetYTitle("\\text{Number of particles detected}");
+    hist->GetXaxis()->CenterTitle();
+    hist->GetYaxis()->CenterTitle();
+    hist->GetXaxis()->SetTitleOffset(1.0);
+    hist->GetYaxis()->SetTitleOffset(1.2);
+    hist->GetXaxis()->SetLabelSize(0.035);
+    hist->GetYaxis()->SetLabelSize(0.04);
+    hist->GetXaxis()->SetTitleSize(0.05);
+    hist->GetYaxis()->SetTitleSize(0.05);
+    hist->Draw("COLZ");
+    events_info_text->Draw();
+
+    canvas->cd(2);
+    efficiency->GetXaxis()->SetTitle("\\text{Acceptance } |\\eta| \\text{ cut}");
+    efficiency->GetYaxis()->SetTitle("\\text{Fraction of events fully detected}");
+    efficiency->GetXaxis()->CenterTitle();
+    efficiency->GetYaxis()->CenterTitle();
+    efficiency->SetMinimum(0);
+    efficiency->SetMaximum(1);
+    efficiency->SetLineColor(kP10Blue);
+    efficiency->SetLineWidth(2);
+    efficiency->Draw("AL");
+
+    // Save plot to TEX file
+    const std::string tex_file_name = base_file_name + std::string(".tex");
+    canvas->Print(tex_file_name.c_str());
+
+    // Save canvas object to ROOT file
+    canvas->Write();
+}
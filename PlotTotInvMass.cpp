@@ -7,28 +7,19 @@
 // Local Includes
 #include "starlyze.cpp" 
 
-void PlotTotInvMass(const std::string& result_file_path = "slight.out") {
-    // Read inn result
-    const SimulationResult results = ReadSimulationResults(result_file_path);
-
-    // Create ROOT output file before any plotting
-    const std::string base_file_name = results.decay_repr_str 
-                                     + std::string("_") + std::to_string(results.n_events)
-                                     + std::string("_") + std::to_string(results.rnd_seed)
-                                     + std::string("_tot_inv_mass");
-    const std::string root_file_name = base_file_name + std::string(".root");
-    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+// Returns finished invariant mass histogram and its peak and FWHM
+CachedResult AnalyseTotInvMass(const std::string& result_file_path, 
+                               const bool& bayesian_blocks,
+                               const bool& print_pipeline_stats) {
+    // Stream inn result, keeping only the invariant mass of each event
+    std::vector<Real> m_inv_list;
+    const SimulationResult results = StreamSimulationResults(result_file_path, 
+        [&](Event& event) { m_inv_list.push_back(event.m_inv); }, false, print_pipeline_stats);
 
     // Create title for plot
     const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s", 
                              results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
 
-    // Create list of all invariant masses
-    std::vector<double> m_inv_list;
-    for (const Event& event : results.events) {
-        m_inv_list.push_back(event.m_inv);
-    }
-
     // Calculate histogram properties
     const double min = std::min_element(m_inv_list.begin(), 
                                         m_inv_list.end())[0];
@@ -37,14 +28,25 @@ void PlotTotInvMass(const std::string& result_file_path = "slight.out") {
     const double bin_width = FreedmanDiaconisBinWidth(m_inv_list);
     const int n_bins = (max - min)/bin_width;
 
-    // Create histogram object
-    TH1D *hist = new TH1D("hist", title, n_bins, min, max);
+    // Create histogram object, with variable width Bayesian Blocks bins if chosen
+    TH1D* hist;
+    if (bayesian_blocks) {
+        const std::vector<double> bin_edges = BayesianBlocksBinEdges(m_inv_list);
+        hist = new TH1D("hist", title, bin_edges.size() - 1, bin_edges.data());
+    } else {
+        hist = new TH1D("hist", title, n_bins, min, max);
+    }
 
     // Fill histograms
-    for (const double& m_inv : m_inv_list) {
+    for (const Real& m_inv : m_inv_list) {
         hist->Fill(m_inv);
     }
 
+    // Variable width bins are compared by counts per unit on the x-axis
+    if (bayesian_blocks) {
+        hist->Scale(1.0/1000000, "width");
+    }
+
     // Calculate invariant mass peak and its FWHM
     const int bin_max = hist->GetMaximumBin();
     const double hist_peak = hist->GetXaxis()->GetBinCenter(bin_max);
@@ -53,11 +55,69 @@ void PlotTotInvMass(const std::string& result_file_path = "slight.out") {
     int fwhm_right = bin_max;
     while (hist->GetBinContent(fwhm_left) > half_max) fwhm_left--;
     while (hist->GetBinContent(fwhm_right) > half_max) fwhm_right++;
-    const double fwhm = hist->GetXaxis()->GetBinCenter(fwhm_right) 
-                      - hist->GetXaxis()->GetBinCenter(fwhm_left);
+    double fwhm = hist->GetXaxis()->GetBinCenter(fwhm_right) 
+                - hist->GetXaxis()->GetBinCenter(fwhm_left);
+
+    // Bayesian Blocks can be wide, so their centers say little about the FWHM.
+    // Use the outer edges of the blocks above half maximum instead.
+    if (bayesian_blocks) {
+        fwhm = hist->GetXaxis()->GetBinUpEdge(fwhm_right - 1) 
+             - hist->GetXaxis()->GetBinLowEdge(fwhm_left + 1);
+    }
+
+    // Store everything needed for plotting
+    CachedResult analysis;
+    analysis.base_file_name = results.decay_repr_str 
+                            + std::string("_") + std::to_string(results.n_events)
+                            + std::string("_") + std::to_string(results.rnd_seed)
+                            + std::string("_tot_inv_mass");
+    analysis.title = title;
+    analysis.n_events = results.n_events;
+    for (int i = 1; i <= hist->GetNbinsX() + 1; i++) {
+        analysis.bin_edges.push_back(hist->GetXaxis()->GetBinLowEdge(i));
+    }
+    for (int i = 1; i <= hist->GetNbinsX(); i++) {
+        analysis.bin_contents["hist"].push_back(hist->GetBinContent(i));
+    }
+    analysis.summary["peak"] = hist_peak;
+    analysis.summary["fwhm"] = fwhm;
+    analysis.summary["bin_width"] = bin_width;
+
+    delete hist;
+    return analysis;
+}
+
+void PlotTotInvMass(const std::string& result_file_path = "slight.out",
+                    const bool& bayesian_blocks = false,
+                    const bool& print_pipeline_stats = false) {
+    // Reuse finished analysis if input and settings are unchanged since last run.
+    // Pipeline stats are only printed when the result is read, so they skip the cache.
+    const std::string cache_key = ResultCacheKey(result_file_path, 
+                                                 Form("PlotTotInvMass %i", bayesian_blocks));
+    CachedResult analysis;
+    if (print_pipeline_stats || !LoadCachedResult(cache_key, analysis)) {
+        analysis = AnalyseTotInvMass(result_file_path, bayesian_blocks, print_pipeline_stats);
+        StoreCachedResult(cache_key, analysis);
+    }
+
+    // Create ROOT output file before any plotting
+    const std::string base_file_name = analysis.base_file_name;
+    const std::string root_file_name = base_file_name + std::string(".root");
+    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+
+    // Create histogram object from finished analysis
+    const std::vector<double>& bin_contents = analysis.bin_contents["hist"];
+    TH1D* hist = new TH1D("hist", analysis.title.c_str(), bin_contents.size(), 
+                          analysis.bin_edges.data());
+    for (std::size_t i = 0; i < bin_contents.size(); i++) {
+        hist->SetBinContent(i + 1, bin_contents[i]);
+    }
+    const double hist_peak = analysis.summary["peak"];
+    const double fwhm = analysis.summary["fwhm"];
+    const double bin_width = analysis.summary["bin_width"];
 
     // Text information about amount of events
-    const char* events_info = Form("\\text{%i events}", results.n_events);
+    const char* events_info = Form("\\text{%i events}", analysis.n_events);
     TLatex* events_info_text = new TLatex(0.54, 0.80, events_info);
     events_info_text->SetNDC();
 
@@ -77,7 +137,11 @@ void PlotTotInvMass(const std::string& result_file_path = "slight.out") {
     // Draw histograms and info texts
     hist->SetStats(kFALSE);
     hist->SetXTitle("\\text{4 Particle Invariant Mass [GeV/c}^{2}\\text{]}");
-    hist->SetYTitle(Form("\\text{Counts per %.2f [keV/c}^{2}\\text{]}", bin_width*1000000));
+    if (bayesian_blocks) {
+        hist->SetYTitle("\\text{Counts per keV/c}^{2}");
+    } else {
+        hist->SetYTitle(Form("\\text{Counts per %.2f [keV/c}^{2}\\text{]}", bin_width*1000000));
+    }
     hist->GetXaxis()->CenterTitle();
     hist->GetYaxis()->CenterTitle();
     hist->GetXaxis()->SetTitleOffset(1.0);
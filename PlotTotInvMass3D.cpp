@@ -0,0 +1,123 @@
+// ROOT Includes
+#include "TH2D.h"
+#include "TCanvas.h"
+#include "TLatex.h"
+#include "TColor.h"
+#include "TFile.h"
+
+// Local Includes
+#include "starlyze.cpp"
+
+// Returns histogram for drawing the occupied bins of a sparse histogram,
+// with bins merged so the dense copy stays small
+TH2D* SparseToTH2D(const SparseHistogram<2>& fine_hist, const char* name, const char* title) {
+    const SparseHistogram<2> sparse_hist = fine_hist.Rebinned(kSPARSE_MAX_DRAWN_BINS);
+    const int nbins_x = sparse_hist.NumBins(0);
+    const int nbins_y = sparse_hist.NumBins(1);
+    TH2D* hist = new TH2D(name, title,
+                          nbins_x, sparse_hist.mins[0], sparse_hist.mins[0] + nbins_x*sparse_hist.bin_widths[0],
+                          nbins_y, sparse_hist.mins[1], sparse_hist.mins[1] + nbins_y*sparse_hist.bin_widths[1]);
+    for (const auto& bin : sparse_hist.bins) {
+        const std::array<std::uint64_t, 2> indices = sparse_hist.BinIndices(bin.first);
+        hist->SetBinContent(indices[0] + 1, indices[1] + 1, bin.second);
+    }
+    return hist;
+}
+
+void PlotTotInvMass3D(const std::string& result_file_path = "slight.out") {
+    // Read inn result
+    const SimulationResult results = ReadSimulationResults(result_file_path);
+
+    // Create ROOT output file before any plotting
+    const std::string base_file_name = results.decay_repr_str
+                                     + std::string("_") + std::to_string(results.n_events)
+                                     + std::string("_") + std::to_string(results.rnd_seed)
+                                     + std::string("_tot_inv_mass_3d");
+    const std::string root_file_name = base_file_name + std::string(".root");
+    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+
+    // Create title for plot
+    const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s",
+                             results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
+
+    // Create list of invariant mass and transverse momentum with one entry per
+    // event, and of all three with pseudo rapidity with one entry per track
+    std::vector<Real> m_inv_list;
+    std::vector<Real> p_trans_list;
+    std::vector<Real> pseudo_rap_list;
+    std::vector<std::array<Real, 2>> event_points;
+    std::vector<std::array<Real, 3>> track_points;
+    for (const Event& event : results.events) {
+        m_inv_list.push_back(event.m_inv);
+        p_trans_list.push_back(event.p_trans);
+        event_points.push_back({event.m_inv, event.p_trans});
+        for (const Real& pseudo_rap : event.pseudo_raps) {
+            pseudo_rap_list.push_back(pseudo_rap);
+            track_points.push_back({event.m_inv, event.p_trans, pseudo_rap});
+        }
+    }
+
+    // Create sparse inv mass vs trans mom vs pseudo rap histogram
+    const std::array<double, 3> mins = {
+        std::min_element(m_inv_list.begin(), m_inv_list.end())[0],
+        std::min_element(p_trans_list.begin(), p_trans_list.end())[0],
+        std::min_element(pseudo_rap_list.begin(), pseudo_rap_list.end())[0]
+    };
+    const std::array<double, 3> bin_widths = {
+        SparseBinWidth(m_inv_list),
+        SparseBinWidth(p_trans_list),
+        SparseBinWidth(pseudo_rap_list)
+    };
+    SparseHistogram<3> sparse_hist(mins, bin_widths);
+    SparseHistogram<2> event_hist({mins[0], mins[1]}, {bin_widths[0], bin_widths[1]});
+
+    // Fill sparse histograms, counting tracks and events respectively
+    sparse_hist.FillParallel(track_points);
+    event_hist.FillParallel(event_points);
+
+    // Inv mass vs trans mom per event, and inv mass vs pseudo rap per track
+    TH2D* hist_p_trans = SparseToTH2D(event_hist, "hist_p_trans", title);
+    TH2D* hist_pseudo_rap = SparseToTH2D(sparse_hist.Project<2>({0, 2}), "hist_pseudo_rap", title);
+
+    // Text information about amount of events
+    const char* events_info = Form("\\text{%i events}", results.n_events);
+    TLatex* events_info_text = new TLatex(0.54, 0.80, events_info);
+    events_info_text->SetNDC();
+
+    // Create a canvas to draw on
+    TCanvas* canvas = new TCanvas("canvas", "", 1800, 700);
+    canvas->Divide(2, 1);
+
+    // Change color pallete
+    gStyle->SetPalette(kDeepSea);
+
+    // Draw histograms and info texts
+    hist_p_trans->SetYTitle("\\text{4 Particle Transverse Momentum  [GeV/c]}");
+    hist_p_trans->SetZTitle("\\text{Events}");
+    hist_pseudo_rap->SetYTitle("\\text{Pseudo rapidity } \\eta");
+    hist_pseudo_rap->SetZTitle("\\text{Tracks}");
+    for (TH2D* hist : {hist_p_trans, hist_pseudo_rap}) {
+        hist->SetStats(kFALSE);
+        hist->SetXTitle("\\text{4 Particle Invariant Mass [GeV/c}^{2}\\text{]}");
+        hist->GetXaxis()->CenterTitle();
+        hist->GetYaxis()->CenterTitle();
+        hist->GetXaxis()->SetTitleOffset(1.0);
+        hist->GetYaxis()->SetTitleOffset(1.2);
+        hist->GetXaxis()->SetLabelSize(0.035);
+        hist->GetYaxis()->SetLabelSize(0.04);
+        hist->GetXaxis()->SetTitleSize(0.05);
+        hist->GetYaxis()->SetTitleSize(0.05);
+    }
+    canvas->cd(1);
+    hist_p_trans->Draw("COLZ");
+    events_info_text->Draw();
+    canvas->cd(2);
+    hist_pseudo_rap->Draw("COLZ");
+
+    // Save plot to TEX file
+    const std::string tex_file_name = base_file_name + std::string(".tex");
+    canvas->Print(tex_file_name.c_str());
+
+    // Save canvas object to ROOT file
+    canvas->Write();
+}
@@ -7,28 +7,19 @@
 // Local Includes
 #include "starlyze.cpp" 
 
-void PlotTotTransMom(const std::string& result_file_path = "slight.out") {
-    // Read inn result
-    const SimulationResult results = ReadSimulationResults(result_file_path);
-
-    // Create ROOT output file before any plotting
-    const std::string base_file_name = results.decay_repr_str 
-                                     + std::string("_") + std::to_string(results.n_events)
-                                     + std::string("_") + std::to_string(results.rnd_seed)
-                                     + std::string("_tot_trans_mom");
-    const std::string root_file_name = base_file_name + std::string(".root");
-    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+// Returns finished transverse momentum histogram and its peak and FWHM
+CachedResult AnalyseTotTransMom(const std::string& result_file_path, 
+                                const bool& bayesian_blocks,
+                                const bool& print_pipeline_stats) {
+    // Stream inn result, keeping only the transverse momentum of each event
+    std::vector<Real> p_trans_list;
+    const SimulationResult results = StreamSimulationResults(result_file_path, 
+        [&](Event& event) { p_trans_list.push_back(event.p_trans); }, false, print_pipeline_stats);
 
     // Create title for plot
     const char* title = Form("\\text{STARlight } | \\text{ Pb - Pb } \\sqrt{s_{NN}} = %.2f \\text{ TeV } | \\, %s", 
                              results.sqrt_s_NN/1000, results.decay_latex_str.c_str());
 
-    // Create list of all invariant masses
-    std::vector<double> p_trans_list;
-    for (const Event& event : results.events) {
-        p_trans_list.push_back(event.p_trans);
-    }
-
     // Calculate histogram properties
     const double min = std::min_element(p_trans_list.begin(), 
                                         p_trans_list.end())[0];
@@ -37,13 +28,25 @@ void PlotTotTransMom(const std::string& result_file_path = "slight.out") {
     const double bin_width = FreedmanDiaconisBinWidth(p_trans_list);
     const int n_bins = (max - min)/bin_width;
 
-    TH1D* hist = new TH1D("hist", title, n_bins, min, max);
+    // Create histogram object, with variable width Bayesian Blocks bins if chosen
+    TH1D* hist;
+    if (bayesian_blocks) {
+        const std::vector<double> bin_edges = BayesianBlocksBinEdges(p_trans_list);
+        hist = new TH1D("hist", title, bin_edges.size() - 1, bin_edges.data());
+    } else {
+        hist = new TH1D("hist", title, n_bins, min, max);
+    }
 
     // Fill histograms
-    for (const double& p_trans : p_trans_list) {
+    for (const Real& p_trans : p_trans_list) {
         hist->Fill(p_trans);
     }
 
+    // Variable width bins are compared by counts per unit on the x-axis
+    if (bayesian_blocks) {
+        hist->Scale(1.0/1000, "width");
+    }
+
     // Calculate invariant mass peak and its FWHM
     const int bin_max = hist->GetMaximumBin();
     const double hist_peak = hist->GetXaxis()->GetBinCenter(bin_max);
@@ -52,11 +55,69 @@ void PlotTotTransMom(const std::string& result_file_path = "slight.out") {
     int fwhm_right = bin_max;
     while (hist->GetBinContent(fwhm_left) > half_max) fwhm_left--;
     while (hist->GetBinContent(fwhm_right) > half_max) fwhm_right++;
-    const double fwhm = hist->GetXaxis()->GetBinCenter(fwhm_right) 
-                      - hist->GetXaxis()->GetBinCenter(fwhm_left);
+    double fwhm = hist->GetXaxis()->GetBinCenter(fwhm_right) 
+                - hist->GetXaxis()->GetBinCenter(fwhm_left);
+
+    // Bayesian Blocks can be wide, so their centers say little about the FWHM.
+    // Use the outer edges of the blocks above half maximum instead.
+    if (bayesian_blocks) {
+        fwhm = hist->GetXaxis()->GetBinUpEdge(fwhm_right - 1) 
+             - hist->GetXaxis()->GetBinLowEdge(fwhm_left + 1);
+    }
+
+    // Store everything needed for plotting
+    CachedResult analysis;
+    analysis.base_file_name = results.decay_repr_str 
+                            + std::string("_") + std::to_string(results.n_events)
+                            + std::string("_") + std::to_string(results.rnd_seed)
+                            + std::string("_tot_trans_mom");
+    analysis.title = title;
+    analysis.n_events = results.n_events;
+    for (int i = 1; i <= hist->GetNbinsX() + 1; i++) {
+        analysis.bin_edges.push_back(hist->GetXaxis()->GetBinLowEdge(i));
+    }
+    for (int i = 1; i <= hist->GetNbinsX(); i++) {
+        analysis.bin_contents["hist"].push_back(hist->GetBinContent(i));
+    }
+    analysis.summary["peak"] = hist_peak;
+    analysis.summary["fwhm"] = fwhm;
+    analysis.summary["bin_width"] = bin_width;
+
+    delete hist;
+    return analysis;
+}
+
+void PlotTotTransMom(const std::string& result_file_path = "slight.out",
+                     const bool& bayesian_blocks = false,
+                     const bool& print_pipeline_stats = false) {
+    // Reuse finished analysis if input and settings are unchanged since last run.
+    // Pipeline stats are only printed when the result is read, so they skip the cache.
+    const std::string cache_key = ResultCacheKey(result_file_path, 
+                                                 Form("PlotTotTransMom %i", bayesian_blocks));
+    CachedResult analysis;
+    if (print_pipeline_stats || !LoadCachedResult(cache_key, analysis)) {
+        analysis = AnalyseTotTransMom(result_file_path, bayesian_blocks, print_pipeline_stats);
+        StoreCachedResult(cache_key, analysis);
+    }
+
+    // Create ROOT output file before any plotting
+    const std::string base_file_name = analysis.base_file_name;
+    const std::string root_file_name = base_file_name + std::string(".root");
+    TFile* root_file = new TFile(root_file_name.c_str(), "recreate");
+
+    // Create histogram object from finished analysis
+    const std::vector<double>& bin_contents = analysis.bin_contents["hist"];
+    TH1D* hist = new TH1D("hist", analysis.title.c_str(), bin_contents.size(), 
+                          analysis.bin_edges.data());
+    for (std::size_t i = 0; i < bin_contents.size(); i++) {
+        hist->SetBinContent(i + 1, bin_contents[i]);
+    }
+    const double hist_peak = analysis.summary["peak"];
+    const double fwhm = analysis.summary["fwhm"];
+    const double bin_width = analysis.summary["bin_width"];
 
     // Text information about amount of events
-    const char* events_info = Form("\\text{%i events}", results.n_events);
+    const char* events_info = Form("\\text{%i events}", analysis.n_events);
     TLatex* events_info_text = new TLatex(0.54, 0.80, events_info);
     events_info_text->SetNDC();
 
@@ -76,7 +137,11 @@ void PlotTotTransMom(const std::string& result_file_path = "slight.out") {
     // Draw histograms and info texts
     hist->SetStats(kFALSE);
     hist->SetXTitle("\\text{4 Particle Transverse Momentum  [GeV/c]}");
-    hist->SetYTitle(Form("\\text{Counts per %.2f [MeV/c]}", bin_width*1000));
+    if (bayesian_blocks) {
+        hist->SetYTitle("\\text{Counts per MeV/c}");
+    } else {
+        hist->SetYTitle(Form("\\text{Counts per %.2f [MeV/c]}", bin_width*1000));
+    }
     hist->SetAxisRange(0, 0.25);
     hist->SetAxisRange(0, hist->GetBinContent(hist->GetMaximumBin())*1.1, "Y");
     hist->GetXaxis()->CenterTitle();
@@ -0,0 +1,15 @@
+// Local Includes
+#include "starlyze.cpp" 
+#include <iostream>
+
+void ValidatePrecision(const std::string& result_file_path = "slight.out") {
+    // Analyse result with both float and double storage
+    const PrecisionDeviation deviation = FloatPrecisionDeviation(result_file_path);
+
+    // Report maximum deviations of the float path
+    std::cout << "Maximum deviation of float from double analysis:\n"
+              << "  Invariant mass:      " << deviation.m_inv*1000000 << " keV/c^2\n"
+              << "  Pair invariant mass: " << deviation.m_inv_pair*1000000 << " keV/c^2\n"
+              << "  Transverse momentum: " << deviation.p_trans*1000000 << " keV/c\n"
+              << "  Pseudo rapidity:     " << deviation.pseudo_rap << "\n";
+}
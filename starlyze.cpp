@@ -1,10 +1,24 @@
 // STD Includes
-#include <cmath>     // std::sqrt, std::log, std::pow
+#include <cmath>     // std::sqrt, std::log, std::pow, std::ceil, std::floor, std::abs, std::nextafter
 #include <random>    // std::random_device, std::mt19937
 #include <vector>    // std::vector
 #include <fstream>   // std::ifstream
-#include <sstream>   // std::istringstream
-#include <algorithm> // std::sort, std::shuffle
+#include <cstdio>    // std::FILE, std::fopen, std::fread
+#include <cstring>   // std::memchr
+#include <iostream>  // std::cerr
+#include <atomic>    // std::atomic
+#include <exception> // std::exception_ptr
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::string
+#include <sstream>   // std::istringstream, std::ostringstream
+#include <algorithm> // std::sort, std::shuffle, std::reverse
+#include <thread>    // std::thread
+#include <array>     // std::array
+#include <cstdint>   // std::uint64_t
+#include <unordered_map> // std::unordered_map
+#include <map>       // std::map
+#include <iomanip>   // std::setprecision
+#include <filesystem> // std::filesystem::create_directories
 
 // Constants (same values as in STARlight 23. Apr. 2025)
 static constexpr double kELECTRON_MASS = 0.000510998928;
@@ -31,12 +45,83 @@ enum DecayId {
     kJPSI_2P = 4432212,
 };
 
-// Initialize RNG stuff
+// Part of every result cache key. Change when analysis results would change.
+static const std::string kSTARLYZE_VERSION = "0.2.1";
+
+// Directory storing finished analyses, keyed by input and configuration
+static const std::string kRESULT_CACHE_DIR = ".starlyze_cache";
+
+// Initialize RNG stuff. Shared default engine for shuffling tracks, readers 
+// which must not depend on earlier reads can pass their own engine instead.
 std::default_random_engine kRNG = std::default_random_engine {};
 
+// Upper limit on bins per axis when drawing a sparse histogram as a dense one
+static constexpr std::uint64_t kSPARSE_MAX_DRAWN_BINS = 1000;
+
+// Upper limit on the fine cells used to pre-bin data for Bayesian Blocks
+static constexpr int kBAYESIAN_BLOCKS_MAX_CELLS = 1 << 14;
+
+// Returns amount of threads to split parallel work over
+int NumThreads() {
+    const int n_threads = std::thread::hardware_concurrency();
+    return std::max(n_threads, 1);
+}
+
+// Splits [0, n_items) into one contiguous chunk per thread and runs
+// task(chunk_begin, chunk_end, thread_index) on each chunk in parallel
+template <typename Task>
+void ParallelForChunks(const std::size_t& n_items, const int& n_threads, Task task) {
+    std::vector<std::thread> threads;
+    const std::size_t chunk_size = (n_items + n_threads - 1) / n_threads;
+    for (int i = 0; i < n_threads; i++) {
+        const std::size_t begin = std::min(n_items, i * chunk_size);
+        const std::size_t end = std::min(n_items, begin + chunk_size);
+        threads.emplace_back(task, begin, end, i);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Data smaller than this is sorted on one thread, as threads would cost more than they save
+static constexpr std::size_t kPARALLEL_SORT_MIN_SIZE = 1 << 16;
+
+// Sorts data by sorting one chunk per thread in parallel, and then merging 
+// neighbouring sorted runs pairwise, with the merges of each round in parallel
+template <typename T>
+void ParallelSort(std::vector<T>& data) {
+    const int n_threads = NumThreads();
+    if (data.size() < kPARALLEL_SORT_MIN_SIZE || n_threads == 1) {
+        std::sort(data.begin(), data.end());
+        return;
+    }
+
+    // Same chunks as ParallelForChunks, so each run below is one sorted chunk
+    const std::size_t chunk_size = (data.size() + n_threads - 1) / n_threads;
+    ParallelForChunks(data.size(), n_threads, 
+        [&](std::size_t begin, std::size_t end, int) {
+            std::sort(data.begin() + begin, data.begin() + end);
+        });
+
+    for (std::size_t run_size = chunk_size; run_size < data.size(); run_size *= 2) {
+        const std::size_t n_merges = (data.size() + 2*run_size - 1) / (2*run_size);
+        ParallelForChunks(n_merges, std::min<std::size_t>(n_threads, n_merges), 
+            [&](std::size_t begin, std::size_t end, int) {
+                for (std::size_t i = begin; i < end; i++) {
+                    const std::size_t first = i * 2*run_size;
+                    const std::size_t middle = std::min(data.size(), first + run_size);
+                    const std::size_t last = std::min(data.size(), first + 2*run_size);
+                    std::inplace_merge(data.begin() + first, data.begin() + middle, 
+                                       data.begin() + last);
+                }
+            });
+    }
+}
+
 // Returns optimal bin-width for data. 
 // Used for plotting histograms in ROOT Macros
-double FreedmanDiaconisBinWidth(std::vector<double> data) {
+template <typename Scalar>
+double FreedmanDiaconisBinWidth(std::vector<Scalar> data) {
     std::sort(data.begin(), data.end());
     const double q1 = data[data.size() / 4];
     const double q3 = data[3 * data.size() / 4];
@@ -45,15 +130,250 @@ double FreedmanDiaconisBinWidth(std::vector<double> data) {
     return bin_width;
 }
 
+// Returns Freedman Diaconis bin-width of data, or a positive fallback when the
+// interquartile range is 0, since sparse histograms divide by their bin widths
+template <typename Scalar>
+double SparseBinWidth(const std::vector<Scalar>& data) {
+    const double bin_width = FreedmanDiaconisBinWidth(data);
+    if (bin_width > 0) return bin_width;
+
+    const double min = std::min_element(data.begin(), data.end())[0];
+    const double max = std::max_element(data.begin(), data.end())[0];
+    return (max > min) ? (max - min) / 100 : 1;
+}
+
+// Returns bin-edges of the Bayesian Blocks partition of data (Scargle et al. 2013).
+// Used for plotting variable width histograms in ROOT Macros.
+// Blocks are built from cells: one cell per unique value if there are at most
+// kBAYESIAN_BLOCKS_MAX_CELLS of them (exact Bayesian Blocks), otherwise that 
+// many cells holding equally many values. Block starts which can never become 
+// optimal again are pruned (PELT). Costs O(N log N) for sorting the N values, 
+// which runs in parallel, plus O(C^2) for the dynamic program over the C cells 
+// in the worst case, i.e. data without structure, where PELT prunes nothing.
+// Data may be stored as float, the edges and all sums are double.
+template <typename Scalar>
+std::vector<double> BayesianBlocksBinEdges(std::vector<Scalar> data,
+                                           const double& false_alarm_prob = 0.05) {
+    ParallelSort(data);
+    const double min = data.front();
+    const double max = data.back();
+
+    // Cell edges between unique values, or between every values_per_cell-th
+    // value, so cells are narrow where data is dense and wide in sparse tails
+    std::size_t n_unique = 1;
+    for (std::size_t i = 1; i < data.size() && n_unique <= kBAYESIAN_BLOCKS_MAX_CELLS; i++) {
+        if (data[i] != data[i - 1]) n_unique += 1;
+    }
+    const std::size_t values_per_cell = (n_unique > kBAYESIAN_BLOCKS_MAX_CELLS) 
+                                      ? (data.size() + kBAYESIAN_BLOCKS_MAX_CELLS - 1) / kBAYESIAN_BLOCKS_MAX_CELLS
+                                      : 1;
+    std::vector<double> cell_edges = {min};
+    for (std::size_t i = values_per_cell; i < data.size(); i += values_per_cell) {
+        if (data[i] != data[i - 1]) cell_edges.push_back(0.5 * (static_cast<double>(data[i - 1]) + data[i]));
+    }
+    cell_edges.push_back(std::nextafter(max, INFINITY));
+    const int n_cells = cell_edges.size() - 1;
+
+    // Cumulative counts, so any block's count is a single subtraction.
+    // The last edge lies just above the maximum, so it is counted like ROOT does.
+    std::vector<double> cum_counts(n_cells + 1, 0);
+    for (int i = 1; i < n_cells; i++) {
+        cum_counts[i] = std::lower_bound(data.begin(), data.end(), cell_edges[i]) - data.begin();
+    }
+    cum_counts[n_cells] = data.size();
+
+    // Prior on amount of blocks, calibrated for data points
+    const double ncp_prior = 4 - std::log(73.53 * false_alarm_prob 
+                                          * std::pow(data.size(), -0.478));
+
+    // Poisson log-likelihood of a block spanning cells [first, last]
+    auto block_fitness = [&](const int& first, const int& last) {
+        const double n = cum_counts[last + 1] - cum_counts[first];
+        const double width = cell_edges[last + 1] - cell_edges[first];
+        return (n > 0 && width > 0) ? n * std::log(n / width) : 0.0;
+    };
+
+    // Dynamic program over cells. best[r] is the optimal fitness of cells [0, r], 
+    // and block_start[r] is the first cell of the last block in that optimum.
+    std::vector<double> best(n_cells);
+    std::vector<int> block_start(n_cells);
+    std::vector<int> candidates;
+    std::vector<double> candidate_fitness;
+    for (int r = 0; r < n_cells; r++) {
+        candidates.push_back(r);
+        candidate_fitness.resize(candidates.size());
+
+        best[r] = -INFINITY;
+        for (std::size_t i = 0; i < candidates.size(); i++) {
+            const int s = candidates[i];
+            candidate_fitness[i] = ((s > 0) ? best[s - 1] : 0) + block_fitness(s, r);
+            if (candidate_fitness[i] - ncp_prior > best[r]) {
+                best[r] = candidate_fitness[i] - ncp_prior;
+                block_start[r] = s;
+            }
+        }
+
+        // Splitting a block never lowers its fitness, so a start this far 
+        // behind the optimum can not catch up for any later cell (PELT)
+        std::size_t n_kept = 0;
+        for (std::size_t i = 0; i < candidates.size(); i++) {
+            if (candidate_fitness[i] >= best[r]) {
+                candidates[n_kept++] = candidates[i];
+            }
+        }
+        candidates.resize(n_kept);
+    }
+
+    // Walk back through the optimal blocks to find their edges
+    std::vector<double> bin_edges = {cell_edges[n_cells]};
+    for (int r = n_cells - 1; r >= 0; r = block_start[r] - 1) {
+        bin_edges.push_back(cell_edges[block_start[r]]);
+    }
+    std::reverse(bin_edges.begin(), bin_edges.end());
+    return bin_edges;
+}
+
+// Histogram over kDims axes which only stores occupied bins, so memory grows
+// with the amount of distinct bins filled instead of the product of all axes.
+// Bin indices along each axis are packed into one 64 bit hash key.
+// Points below an axis minimum or beyond the packable index range are dropped.
+// Points may be stored as float, bin geometry and contents are double.
+template <std::size_t kDims>
+class SparseHistogram {
+    public:
+    static constexpr int kBITS_PER_AXIS = 64 / kDims;
+    static constexpr std::uint64_t kINDEX_MASK = (kDims == 1) ? ~std::uint64_t(0)
+                                               : (std::uint64_t(1) << kBITS_PER_AXIS) - 1;
+
+    std::array<double, kDims> mins, bin_widths;
+    std::unordered_map<std::uint64_t, double> bins;
+
+    SparseHistogram(const std::array<double, kDims>& mins, 
+                    const std::array<double, kDims>& bin_widths) {
+        this->mins = mins;
+        this->bin_widths = bin_widths;
+    }
+
+    // Returns false if point is outside of the histogram
+    template <typename Scalar>
+    bool BinKey(const std::array<Scalar, kDims>& point, std::uint64_t& key) const {
+        key = 0;
+        for (std::size_t axis = 0; axis < kDims; axis++) {
+            const double index = std::floor((point[axis] - mins[axis]) / bin_widths[axis]);
+            if (!(index >= 0 && index < kINDEX_MASK)) return false;
+            key |= static_cast<std::uint64_t>(index) << (axis * kBITS_PER_AXIS);
+        }
+        return true;
+    }
+
+    std::array<std::uint64_t, kDims> BinIndices(const std::uint64_t& key) const {
+        std::array<std::uint64_t, kDims> indices;
+        for (std::size_t axis = 0; axis < kDims; axis++) {
+            indices[axis] = (key >> (axis * kBITS_PER_AXIS)) & kINDEX_MASK;
+        }
+        return indices;
+    }
+
+    double BinCenter(const std::size_t& axis, const std::uint64_t& index) const {
+        return mins[axis] + (index + 0.5) * bin_widths[axis];
+    }
+
+    // Returns amount of bins needed along axis to cover all occupied bins
+    std::uint64_t NumBins(const std::size_t& axis) const {
+        std::uint64_t n_bins = 0;
+        for (const auto& bin : bins) {
+            n_bins = std::max(n_bins, BinIndices(bin.first)[axis] + 1);
+        }
+        return n_bins;
+    }
+
+    template <typename Scalar>
+    void Fill(const std::array<Scalar, kDims>& point, const double& weight = 1) {
+        std::uint64_t key;
+        if (BinKey(point, key)) bins[key] += weight;
+    }
+
+    void Merge(const SparseHistogram<kDims>& other) {
+        for (const auto& bin : other.bins) {
+            bins[bin.first] += bin.second;
+        }
+    }
+
+    // Fills all points using one partial histogram per thread, 
+    // which are merged into this histogram afterwards
+    template <typename Scalar>
+    void FillParallel(const std::vector<std::array<Scalar, kDims>>& points) {
+        const int n_threads = NumThreads();
+        std::vector<SparseHistogram<kDims>> partials(n_threads, SparseHistogram<kDims>(mins, bin_widths));
+        ParallelForChunks(points.size(), n_threads, 
+            [&](std::size_t begin, std::size_t end, int thread_index) {
+                for (std::size_t i = begin; i < end; i++) {
+                    partials[thread_index].Fill(points[i]);
+                }
+            });
+        for (const SparseHistogram<kDims>& partial : partials) {
+            Merge(partial);
+        }
+    }
+
+    // Returns projection onto the given axes, summing over all other axes.
+    // Only occupied bins are visited.
+    template <std::size_t kProjDims>
+    SparseHistogram<kProjDims> Project(const std::array<std::size_t, kProjDims>& axes) const {
+        std::array<double, kProjDims> proj_mins, proj_bin_widths;
+        for (std::size_t i = 0; i < kProjDims; i++) {
+            proj_mins[i] = mins[axes[i]];
+            proj_bin_widths[i] = bin_widths[axes[i]];
+        }
+
+        SparseHistogram<kProjDims> projection(proj_mins, proj_bin_widths);
+        for (const auto& bin : bins) {
+            const std::array<std::uint64_t, kDims> indices = BinIndices(bin.first);
+            std::uint64_t proj_key = 0;
+            for (std::size_t i = 0; i < kProjDims; i++) {
+                proj_key |= indices[axes[i]] << (i * projection.kBITS_PER_AXIS);
+            }
+            projection.bins[proj_key] += bin.second;
+        }
+        return projection;
+    }
+
+    // Returns histogram with neighbouring bins merged, so no axis needs more
+    // than max_bins bins to cover the occupied bins. Only occupied bins are visited.
+    SparseHistogram<kDims> Rebinned(const std::uint64_t& max_bins) const {
+        std::array<std::uint64_t, kDims> factors;
+        std::array<double, kDims> rebinned_widths;
+        for (std::size_t axis = 0; axis < kDims; axis++) {
+            factors[axis] = std::max<std::uint64_t>(1, (NumBins(axis) + max_bins - 1) / max_bins);
+            rebinned_widths[axis] = bin_widths[axis] * factors[axis];
+        }
+
+        SparseHistogram<kDims> rebinned(mins, rebinned_widths);
+        for (const auto& bin : bins) {
+            const std::array<std::uint64_t, kDims> indices = BinIndices(bin.first);
+            std::uint64_t rebinned_key = 0;
+            for (std::size_t axis = 0; axis < kDims; axis++) {
+                rebinned_key |= (indices[axis] / factors[axis]) << (axis * kBITS_PER_AXIS);
+            }
+            rebinned.bins[rebinned_key] += bin.second;
+        }
+        return rebinned;
+    }
+};
+
 // Returns vector containg sub-strings seperated by passed delimiter
 std::vector<std::string> SplitStringBy(const std::string& string, 
                                        const char& delimiter) {
     std::vector<std::string> string_segments;
-    std::istringstream string_stream(string);
-    std::string segment;
-    
-    while (std::getline(string_stream, segment, delimiter)) {
-        string_segments.push_back(segment);
+    std::size_t segment_begin = 0;
+    std::size_t segment_end;
+
+    // Same segments as std::getline would give, without its stream overhead
+    while (segment_begin < string.size()) {
+        segment_end = string.find(delimiter, segment_begin);
+        if (segment_end == std::string::npos) segment_end = string.size();
+        string_segments.push_back(string.substr(segment_begin, segment_end - segment_begin));
+        segment_begin = segment_end + 1;
     }
 
     return string_segments;
@@ -149,38 +469,56 @@ std::string DecayIdToLatexStr(const int& decay_id) {
     return latex_str;
 }
 
-class Track {
+// Track and Event store their values as Scalar (float or double). Sums where
+// float would lose precision, like E^2 - p^2 in the invariant mass, are always
+// accumulated in double before the result is stored.
+template <typename Scalar>
+class BasicTrack {
     public:
-    double E, px, py, pz, pseudo_rap;
+    Scalar px, py, pz, m, pseudo_rap;
 
-    Track(const double& px, const double& py, const double& pz, const double& m) {
+    BasicTrack(const double& px, const double& py, const double& pz, const double& m) {
         const double p_mag = std::sqrt(px*px + py*py + pz*pz);
-        this->E = std::sqrt(p_mag*p_mag + m*m);
         this->px = px;
         this->py = py;
         this->pz = pz;
+        this->m = m;
         this->pseudo_rap = 0.5 * std::log((p_mag + pz) / (p_mag - pz));
     }
+
+    // Energy is not stored, as a separately rounded float energy would break the
+    // E^2 - p^2 = m^2 relation the invariant masses rely on. It is computed
+    // in double from the stored momentum and mass instead.
+    double E() const {
+        const double px = this->px;
+        const double py = this->py;
+        const double pz = this->pz;
+        const double m = this->m;
+        return std::sqrt(px*px + py*py + pz*pz + m*m);
+    }
 };
 
-class Event {
+template <typename Scalar>
+class BasicEvent {
     public:
-    double m_inv, p_trans;
-    std::vector<double> m_inv_pairs, pseudo_raps;
+    Scalar m_inv, p_trans;
+    std::vector<Scalar> m_inv_pairs, pseudo_raps;
+    std::vector<BasicTrack<Scalar>> tracks;  // Only kept if asked for, e.g. for event mixing
 
-    Event(std::vector<Track> tracks) {
+    BasicEvent(std::vector<BasicTrack<Scalar>> tracks, const bool& keep_tracks = false,
+               std::default_random_engine& rng = kRNG) {
         // In real life, we don't know which particle is which in the detector.
         // Thus we shuffle the list of tracks to remove our knowldege of which
         // track is which particle.
-        std::shuffle(tracks.begin(), tracks.end(), kRNG);
+        std::shuffle(tracks.begin(), tracks.end(), rng);
 
         double E1, E2, px1, px2, py1, py2, pz1, pz2, m_inv_1, m_inv_2;
 
         // Calculate invariant mass of the system of the first pair of particles
-        E1  =  tracks[0].E + tracks[1].E;
-        px1 = tracks[0].px + tracks[1].px;
-        py1 = tracks[0].py + tracks[1].py;
-        pz1 = tracks[0].pz + tracks[1].pz;
+        E1  = tracks[0].E() + tracks[1].E();
+        px1 = static_cast<double>(tracks[0].px) + tracks[1].px;
+        py1 = static_cast<double>(tracks[0].py) + tracks[1].py;
+        pz1 = static_cast<double>(tracks[0].pz) + tracks[1].pz;
 
         m_inv_1 = std::sqrt(E1*E1 - px1*px1 - py1*py1 - pz1*pz1);
         this->m_inv_pairs.push_back(m_inv_1);
@@ -188,10 +526,10 @@ class Event {
         // Calculate invariant mass of the system of the second pair of particles
         // if there is a second pair
         if (tracks.size() == 4) {
-            E2  =  tracks[2].E + tracks[3].E;
-            px2 = tracks[2].px + tracks[3].px;
-            py2 = tracks[2].py + tracks[3].py;
-            pz2 = tracks[2].pz + tracks[3].pz;
+            E2  = tracks[2].E() + tracks[3].E();
+            px2 = static_cast<double>(tracks[2].px) + tracks[3].px;
+            py2 = static_cast<double>(tracks[2].py) + tracks[3].py;
+            pz2 = static_cast<double>(tracks[2].pz) + tracks[3].pz;
 
             m_inv_2 = std::sqrt(E2*E2 - px2*px2 - py2*py2 - pz2*pz2);
             this->m_inv_pairs.push_back(m_inv_2);
@@ -214,26 +552,31 @@ class Event {
         this->p_trans = std::sqrt(px*px + py*py);
 
         // Add all pseudo rapidities to pseudo rap. list
-        for (const Track& track : tracks){
+        for (const BasicTrack<Scalar>& track : tracks){
             this->pseudo_raps.push_back(track.pseudo_rap);
         }
+
+        if (keep_tracks) this->tracks = std::move(tracks);
     }
 };
 
-class SimulationResult {
+template <typename Scalar>
+class BasicSimulationResult {
     public:
+    int decay_id;
     int rnd_seed;
     int n_events;
     double sqrt_s_NN;
     std::string decay_repr_str; 
     std::string decay_latex_str;
-    std::vector<Event> events;
+    std::vector<BasicEvent<Scalar>> events;
 
-    SimulationResult(const std::vector<Event>& events, const int& decay_id, 
-                     const int& rnd_seed, const double& beam_1_gamma, 
-                     const double& beam_2_gamma) {
+    BasicSimulationResult(const std::vector<BasicEvent<Scalar>>& events, const int& decay_id, 
+                          const int& rnd_seed, const double& beam_1_gamma, 
+                          const double& beam_2_gamma) {
 
         // Used to display in plots and file names
+        this->decay_id = decay_id;
         this->rnd_seed = rnd_seed;
         this->n_events = events.size();
         this->decay_repr_str = DecayIdToReprStr(decay_id);
@@ -248,56 +591,673 @@ class SimulationResult {
     }
 };
 
-SimulationResult ReadSimulationResults(const std::string& result_file_path) {
-    // Variables for track and event values
-    double m, px, py, pz, beam_1_gamma, beam_2_gamma;
-    int particle_id, decay_id, rnd_seed;
-    std::vector<Track> tracks;
-    std::vector<Event> events;
-
-    // Variables used for parsing
-    int tracks_remaining_in_event;
-    std::ifstream result_file(result_file_path);
-    std::string line;
-    std::vector<std::string> line_segments;
-
-    // Go through each line in result_file
-    while (std::getline(result_file, line)) {
-        line_segments = SplitStringBy(line, ' ');
-
-        if (line_segments[0] == std::string("CONFIG_OPT:")) {
-            decay_id = std::stoi(line_segments[2]);
-            rnd_seed = std::stoi(line_segments[6]);
-        } 
-        else if (line_segments[0] == std::string("BEAM_1:")) {
-            beam_1_gamma = std::stod(line_segments[3]);
-        } 
-        else if (line_segments[0] == std::string("BEAM_2:")) {
-            beam_2_gamma = std::stod(line_segments[3]);
-        } 
-        else if (line_segments[0] == std::string("EVENT:")) {
-            tracks_remaining_in_event = std::stoi(line_segments[2]);
-        } 
-        else if (line_segments[0] == std::string("TRACK:") && tracks_remaining_in_event != 0) {
-            px = std::stod(line_segments[3]);
-            py = std::stod(line_segments[4]);
-            pz = std::stod(line_segments[5]);
-            particle_id = std::stoi(line_segments[9]);
-            m = ParticleIdToMass(particle_id);
-            
-            Track track(px, py, pz, m);
-            tracks.push_back(track);
-
-            tracks_remaining_in_event -= 1;
-        }
-
-        if (tracks_remaining_in_event == 0) {
-            Event event(tracks);
-            events.push_back(event);
-            tracks.clear();
-        }
-    }
-
-    result_file.close();
-    return SimulationResult(events, decay_id, rnd_seed, beam_1_gamma, beam_2_gamma);
+// Precision of the analysis core used by the ROOT Macros.
+// Define STARLYZE_SINGLE_PRECISION before including this file for float storage.
+#ifdef STARLYZE_SINGLE_PRECISION
+using Real = float;
+#else
+using Real = double;
+#endif
+
+using Track = BasicTrack<Real>;
+using Event = BasicEvent<Real>;
+using SimulationResult = BasicSimulationResult<Real>;
+
+// Lines read, and events built, per batch passed between pipeline stages
+static constexpr std::size_t kPIPELINE_BATCH_SIZE = 1024;
+
+// Batches which can wait between two pipeline stages
+static constexpr std::size_t kPIPELINE_QUEUE_CAPACITY = 64;
+
+// Bytes read at a time from result file or standard input
+static constexpr std::size_t kPIPELINE_READ_BLOCK_SIZE = 1 << 20;
+
+// Bounded lock-free single-producer/single-consumer ring buffer connecting
+// two pipeline stages. Counts how often each side had to wait on the other.
+template <typename T>
+class SpscQueue {
+    public:
+    std::size_t n_batches = 0;
+    std::size_t n_full_waits = 0;   // Producer found queue full (back-pressure)
+    std::size_t n_empty_waits = 0;  // Consumer found queue empty (starvation)
+
+    SpscQueue(const std::size_t& capacity) : slots(capacity + 1) {}
+
+    // Only called by the producer
+    void Push(T item) {
+        const std::size_t tail_now = tail.load(std::memory_order_relaxed);
+        const std::size_t tail_next = (tail_now + 1) % slots.size();
+        if (tail_next == head.load(std::memory_order_acquire)) {
+            n_full_waits += 1;
+            while (tail_next == head.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        slots[tail_now] = std::move(item);
+        tail.store(tail_next, std::memory_order_release);
+        n_batches += 1;
+    }
+
+    // Only called by the producer, after its last push
+    void Close() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    // Only called by the consumer. Returns false once queue is closed and empty.
+    bool Pop(T& item) {
+        const std::size_t head_now = head.load(std::memory_order_relaxed);
+        if (head_now == tail.load(std::memory_order_acquire)) {
+            n_empty_waits += 1;
+            while (head_now == tail.load(std::memory_order_acquire)) {
+                if (closed.load(std::memory_order_acquire)
+                    && head_now == tail.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                std::this_thread::yield();
+            }
+        }
+        item = std::move(slots[head_now]);
+        head.store((head_now + 1) % slots.size(), std::memory_order_release);
+        return true;
+    }
+
+    private:
+    std::vector<T> slots;
+    std::atomic<std::size_t> head {0};
+    std::atomic<std::size_t> tail {0};
+    std::atomic<bool> closed {false};
+};
+
+// Streams STARlight result file, or standard input if path is "-", handing each
+// event to accumulate(event) as soon as it is built, in file order. Returns the result
+// without its events, which are not stored. Throws std::runtime_error if the
+// input can not be opened or read, and rethrows errors of parsing and accumulate.
+// Reading runs as a pipeline of reader -> tokenizer -> kinematics -> accumulation
+// stages. The first three run on their own threads, and accumulation on the
+// calling thread. Stages pass batches through bounded SPSC queues.
+// Set keep_tracks to keep the tracks of each event, which only event mixing needs.
+// Set print_pipeline_stats to print the back-pressure of each queue to stderr.
+// Tracks are shuffled with rng, which only the kinematics stage uses while reading.
+template <typename Scalar = Real, typename Accumulate>
+BasicSimulationResult<Scalar> StreamSimulationResults(const std::string& result_file_path,
+                                                      const Accumulate& accumulate,
+                                                      const bool& keep_tracks = false,
+                                                      const bool& print_pipeline_stats = false,
+                                                      std::default_random_engine& rng = kRNG) {
+    // Header values, written by the tokenizer and read after it is joined
+    double beam_1_gamma = 0;
+    double beam_2_gamma = 0;
+    int decay_id = 0;
+    int rnd_seed = 0;
+    std::exception_ptr read_error;
+    std::exception_ptr parse_error;
+    std::exception_ptr accumulate_error;
+
+    // Tracks of one event as px, py, pz and mass
+    using TrackValues = std::array<double, 4>;
+
+    // Queues between stages
+    SpscQueue<std::vector<std::string>> line_queue(kPIPELINE_QUEUE_CAPACITY);
+    SpscQueue<std::vector<std::vector<TrackValues>>> track_queue(kPIPELINE_QUEUE_CAPACITY);
+    SpscQueue<std::vector<BasicEvent<Scalar>>> event_queue(kPIPELINE_QUEUE_CAPACITY);
+
+    // Reader stage: Batches lines of result file or standard input. Reads large
+    // blocks through C stdio, since line by line reads of std::cin are slow.
+    // Failing to open or read the input is rethrown once all stages are joined.
+    std::thread reader([&]() {
+        std::FILE* input = (result_file_path == "-") ? stdin 
+                                                     : std::fopen(result_file_path.c_str(), "rb");
+        if (input == nullptr) {
+            read_error = std::make_exception_ptr(std::runtime_error(
+                "Can not open result file " + result_file_path));
+        }
+
+        std::vector<std::string> lines;
+        std::string line;
+        std::vector<char> block(kPIPELINE_READ_BLOCK_SIZE);
+        std::size_t n_read;
+        while (input != nullptr && (n_read = std::fread(block.data(), 1, block.size(), input)) > 0) {
+            const char* begin = block.data();
+            const char* end = begin + n_read;
+            while (const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin))) {
+                line.append(begin, newline);
+                lines.push_back(std::move(line));
+                line.clear();
+                if (lines.size() == kPIPELINE_BATCH_SIZE) {
+                    line_queue.Push(std::move(lines));
+                    lines.clear();
+                }
+                begin = newline + 1;
+            }
+            // Rest of a line which continues in the next block
+            line.append(begin, end);
+        }
+        if (!line.empty()) lines.push_back(std::move(line));
+        if (!lines.empty()) line_queue.Push(std::move(lines));
+        line_queue.Close();
+
+        if (input != nullptr && std::ferror(input)) {
+            read_error = std::make_exception_ptr(std::runtime_error(
+                "Can not read result file " + result_file_path));
+        }
+        if (input != nullptr && input != stdin) std::fclose(input);
+    });
+
+    // Tokenizer stage: Parses lines into header values and tracks of events.
+    // After a malformed line it only drains the reader, and the error is
+    // rethrown once all stages are joined.
+    std::thread tokenizer([&]() {
+        int tracks_remaining_in_event = 0;
+        std::vector<std::string> lines;
+        std::vector<std::string> line_segments;
+        std::vector<TrackValues> tracks;
+        std::vector<std::vector<TrackValues>> events;
+
+        while (line_queue.Pop(lines)) {
+            for (const std::string& line : lines) {
+                if (parse_error) break;
+                try {
+                    line_segments = SplitStringBy(line, ' ');
+                    if (line_segments.empty()) continue;
+
+                    if (line_segments[0] == std::string("CONFIG_OPT:")) {
+                        decay_id = std::stoi(line_segments.at(2));
+                        rnd_seed = std::stoi(line_segments.at(6));
+                    } 
+                    else if (line_segments[0] == std::string("BEAM_1:")) {
+                        beam_1_gamma = std::stod(line_segments.at(3));
+                    } 
+                    else if (line_segments[0] == std::string("BEAM_2:")) {
+                        beam_2_gamma = std::stod(line_segments.at(3));
+                    } 
+                    else if (line_segments[0] == std::string("EVENT:")) {
+                        tracks_remaining_in_event = std::stoi(line_segments.at(2));
+                    } 
+                    else if (line_segments[0] == std::string("TRACK:") && tracks_remaining_in_event != 0) {
+                        const double px = std::stod(line_segments.at(3));
+                        const double py = std::stod(line_segments.at(4));
+                        const double pz = std::stod(line_segments.at(5));
+                        const int particle_id = std::stoi(line_segments.at(9));
+                        const double m = ParticleIdToMass(particle_id);
+                        tracks.push_back({px, py, pz, m});
+
+                        tracks_remaining_in_event -= 1;
+
+                        if (tracks_remaining_in_event == 0) {
+                            events.push_back(std::move(tracks));
+                            tracks.clear();
+                        }
+                    }
+                } catch (...) {
+                    parse_error = std::current_exception();
+                }
+            }
+
+            if (events.size() >= kPIPELINE_BATCH_SIZE) {
+                track_queue.Push(std::move(events));
+                events.clear();
+            }
+        }
+        if (!events.empty()) track_queue.Push(std::move(events));
+        track_queue.Close();
+    });
+
+    // Kinematics stage: Builds tracks and events, in the order they were read
+    std::thread kinematics([&]() {
+        std::vector<std::vector<TrackValues>> track_values_batch;
+        std::vector<BasicTrack<Scalar>> tracks;
+
+        while (track_queue.Pop(track_values_batch)) {
+            std::vector<BasicEvent<Scalar>> events;
+            for (const std::vector<TrackValues>& track_values : track_values_batch) {
+                tracks.clear();
+                for (const TrackValues& values : track_values) {
+                    tracks.push_back(BasicTrack<Scalar>(values[0], values[1], values[2], values[3]));
+                }
+                events.push_back(BasicEvent<Scalar>(tracks, keep_tracks, rng));
+            }
+            event_queue.Push(std::move(events));
+        }
+        event_queue.Close();
+    });
+
+    // Accumulation stage: Hands each event to accumulate. After an error in
+    // accumulate it only drains the queue, so all stages can be joined.
+    int n_events = 0;
+    std::vector<BasicEvent<Scalar>> event_batch;
+    while (event_queue.Pop(event_batch)) {
+        if (accumulate_error) continue;
+        try {
+            for (BasicEvent<Scalar>& event : event_batch) {
+                accumulate(event);
+                n_events += 1;
+            }
+        } catch (...) {
+            accumulate_error = std::current_exception();
+        }
+    }
+
+    reader.join();
+    tokenizer.join();
+    kinematics.join();
+
+    if (read_error) std::rethrow_exception(read_error);
+    if (parse_error) std::rethrow_exception(parse_error);
+    if (accumulate_error) std::rethrow_exception(accumulate_error);
+
+    if (print_pipeline_stats) {
+        std::cerr << "Pipeline queue       batches  producer waits  consumer waits\n"
+                  << "reader -> tokenizer  " << line_queue.n_batches << "  " 
+                  << line_queue.n_full_waits << "  " << line_queue.n_empty_waits << "\n"
+                  << "tokenizer -> kinem.  " << track_queue.n_batches << "  " 
+                  << track_queue.n_full_waits << "  " << track_queue.n_empty_waits << "\n"
+                  << "kinem. -> accum.     " << event_queue.n_batches << "  " 
+                  << event_queue.n_full_waits << "  " << event_queue.n_empty_waits << "\n";
+    }
+
+    BasicSimulationResult<Scalar> results({}, decay_id, rnd_seed, beam_1_gamma, beam_2_gamma);
+    results.n_events = n_events;
+    return results;
+}
+
+// Reads STARlight result file, or standard input if path is "-", 
+// collecting all events through the pipeline of StreamSimulationResults.
+template <typename Scalar = Real>
+BasicSimulationResult<Scalar> ReadSimulationResults(const std::string& result_file_path,
+                                                    const bool& keep_tracks = false,
+                                                    const bool& print_pipeline_stats = false,
+                                                    std::default_random_engine& rng = kRNG) {
+    std::vector<BasicEvent<Scalar>> events;
+    BasicSimulationResult<Scalar> results = StreamSimulationResults<Scalar>(result_file_path,
+        [&](BasicEvent<Scalar>& event) { events.push_back(std::move(event)); },
+        keep_tracks, print_pipeline_stats, rng);
+    results.events = std::move(events);
+    return results;
+}
+
+// Largest absolute deviations of the float analysis path from the double path
+struct PrecisionDeviation {
+    double m_inv = 0;
+    double p_trans = 0;
+    double m_inv_pair = 0;
+    double pseudo_rap = 0;
+};
+
+// Returns the largest deviations of the float path from the double path,
+// when analysing the same result file with both
+PrecisionDeviation FloatPrecisionDeviation(const std::string& result_file_path) {
+    // Both paths must shuffle the tracks of each event identically
+    std::default_random_engine double_rng;
+    std::default_random_engine float_rng;
+    const BasicSimulationResult<double> double_results = ReadSimulationResults<double>(result_file_path, 
+                                                                                       false, false, double_rng);
+    const BasicSimulationResult<float> float_results = ReadSimulationResults<float>(result_file_path, 
+                                                                                    false, false, float_rng);
+
+    PrecisionDeviation deviation;
+    for (int i = 0; i < double_results.n_events; i++) {
+        const BasicEvent<double>& double_event = double_results.events[i];
+        const BasicEvent<float>& float_event = float_results.events[i];
+
+        deviation.m_inv = std::max(deviation.m_inv, 
+                                   std::abs(double_event.m_inv - float_event.m_inv));
+        deviation.p_trans = std::max(deviation.p_trans, 
+                                     std::abs(double_event.p_trans - float_event.p_trans));
+        for (std::size_t j = 0; j < double_event.m_inv_pairs.size(); j++) {
+            deviation.m_inv_pair = std::max(deviation.m_inv_pair, 
+                                            std::abs(double_event.m_inv_pairs[j] - float_event.m_inv_pairs[j]));
+        }
+        for (std::size_t j = 0; j < double_event.pseudo_raps.size(); j++) {
+            deviation.pseudo_rap = std::max(deviation.pseudo_rap, 
+                                            std::abs(double_event.pseudo_raps[j] - float_event.pseudo_raps[j]));
+        }
+    }
+
+    return deviation;
+}
+
+// Tracks of the most recent events of one event class, stored as a structure
+// of arrays so the mixed pair invariant masses can be computed vectorized
+struct MixingPool {
+    std::vector<double> E, px, py, pz;
+    std::vector<std::size_t> event_n_tracks;  // Oldest event first
+
+    template <typename Scalar>
+    void Add(const BasicEvent<Scalar>& event, const std::size_t& depth) {
+        // Drop oldest event when pool is full
+        if (event_n_tracks.size() == depth) {
+            const std::size_t n_old = event_n_tracks[0];
+            E.erase(E.begin(), E.begin() + n_old);
+            px.erase(px.begin(), px.begin() + n_old);
+            py.erase(py.begin(), py.begin() + n_old);
+            pz.erase(pz.begin(), pz.begin() + n_old);
+            event_n_tracks.erase(event_n_tracks.begin());
+        }
+
+        for (const BasicTrack<Scalar>& track : event.tracks) {
+            E.push_back(track.E());
+            px.push_back(track.px);
+            py.push_back(track.py);
+            pz.push_back(track.pz);
+        }
+        event_n_tracks.push_back(event.tracks.size());
+    }
+};
+
+// Returns counts per bin of the invariant masses of track pairs taken from 
+// different events (event mixing), as estimate of the uncorrelated background.
+// Events are split into classes of equal population by total transverse momentum,
+// and each event is only mixed with the last pool_depth events of its class.
+// Classes are independent, so they are mixed in parallel.
+// Events must be read with keep_tracks set.
+template <typename Scalar>
+std::vector<double> MixedEventPairInvMassCounts(const std::vector<BasicEvent<Scalar>>& events,
+                                                const std::vector<double>& bin_edges,
+                                                const int& n_classes = 10,
+                                                const std::size_t& pool_depth = 10) {
+    // Class boundaries at quantiles of the total transverse momentum
+    std::vector<double> p_trans_sorted;
+    for (const BasicEvent<Scalar>& event : events) {
+        p_trans_sorted.push_back(event.p_trans);
+    }
+    std::sort(p_trans_sorted.begin(), p_trans_sorted.end());
+    std::vector<double> class_edges;
+    for (int i = 1; i < n_classes; i++) {
+        class_edges.push_back(p_trans_sorted[i * p_trans_sorted.size() / n_classes]);
+    }
+
+    // Events of each class, in the order they were read
+    std::vector<std::vector<std::size_t>> class_events(n_classes);
+    for (std::size_t i = 0; i < events.size(); i++) {
+        const int event_class = std::upper_bound(class_edges.begin(), class_edges.end(), 
+                                                 events[i].p_trans) - class_edges.begin();
+        class_events[event_class].push_back(i);
+    }
+
+    // Squared bin edges, keeping the sign so the edge order is unchanged
+    std::vector<double> bin_edges_sq;
+    for (const double& bin_edge : bin_edges) {
+        bin_edges_sq.push_back(bin_edge*std::abs(bin_edge));
+    }
+
+    // Mix each class, with one set of counts per thread
+    const int n_bins = bin_edges.size() - 1;
+    const int n_threads = std::min(NumThreads(), n_classes);
+    std::vector<std::vector<double>> thread_counts(n_threads, std::vector<double>(n_bins, 0));
+    ParallelForChunks(n_classes, n_threads, 
+        [&](std::size_t begin, std::size_t end, int thread_index) {
+            std::vector<double>& counts = thread_counts[thread_index];
+            std::vector<double> m_inv_sq_mixed;
+
+            for (std::size_t c = begin; c < end; c++) {
+                MixingPool pool;
+                for (const std::size_t& i : class_events[c]) {
+                    const std::size_t n_pool = pool.E.size();
+                    m_inv_sq_mixed.resize(n_pool);
+
+                    for (const BasicTrack<Scalar>& track : events[i].tracks) {
+                        const double track_E = track.E();
+                        const double track_px = track.px;
+                        const double track_py = track.py;
+                        const double track_pz = track.pz;
+
+                        // Branch free loop over the pool, so it can be vectorized. Squared
+                        // masses are kept, since sqrt may set errno and block vectorization
+                        for (std::size_t j = 0; j < n_pool; j++) {
+                            const double  E = track_E  + pool.E[j];
+                            const double px = track_px + pool.px[j];
+                            const double py = track_py + pool.py[j];
+                            const double pz = track_pz + pool.pz[j];
+                            m_inv_sq_mixed[j] = std::max(E*E - px*px - py*py - pz*pz, 0.0);
+                        }
+
+                        for (const double& m_inv_sq : m_inv_sq_mixed) {
+                            const int bin = std::upper_bound(bin_edges_sq.begin(), bin_edges_sq.end(), 
+                                                             m_inv_sq) - bin_edges_sq.begin() - 1;
+                            if (bin >= 0 && bin < n_bins) counts[bin] += 1;
+                        }
+                    }
+
+                    pool.Add(events[i], pool_depth);
+                }
+            }
+        });
+
+    // Merge counts of all threads
+    std::vector<double> counts(n_bins, 0);
+    for (const std::vector<double>& partial_counts : thread_counts) {
+        for (int bin = 0; bin < n_bins; bin++) {
+            counts[bin] += partial_counts[bin];
+        }
+    }
+    return counts;
+}
+
+// Events per amount of tracks detected, for every cut in an acceptance scan
+struct AcceptanceScan {
+    std::vector<std::vector<double>> detected_counts;  // [n_detected][cut_index]
+    std::vector<double> full_detection_counts;         // [cut_index]
+};
+
+// Counts events with 0, 1, 2, ... tracks inside the acceptance |eta| < cut,
+// for every cut in the ascending list of cuts, adding one event at a time.
+// Each event's |eta| values are sorted once. The k-th smallest one decides 
+// from which cut on at least k tracks are detected, so each event only adds
+// its range boundaries to difference arrays, and one prefix sum over the cuts
+// gives all counts. Costs O(N log K + K) instead of O(N K) for N events and K cuts.
+class AcceptanceScanner {
+    public:
+    std::vector<double> cuts;
+    std::vector<std::vector<double>> detected_diffs;  // [n_detected][cut_index]
+    std::vector<double> full_diffs;                   // [cut_index]
+
+    AcceptanceScanner(const std::vector<double>& cuts) {
+        this->cuts = cuts;
+        this->detected_diffs.assign(1, std::vector<double>(cuts.size() + 1, 0));
+        this->full_diffs.assign(cuts.size() + 1, 0);
+    }
+
+    template <typename Scalar>
+    void Add(const std::vector<Scalar>& pseudo_raps) {
+        abs_pseudo_raps.clear();
+        for (const Scalar& pseudo_rap : pseudo_raps) {
+            abs_pseudo_raps.push_back(std::abs(pseudo_rap));
+        }
+        std::sort(abs_pseudo_raps.begin(), abs_pseudo_raps.end());
+        if (detected_diffs.size() <= abs_pseudo_raps.size()) {
+            detected_diffs.resize(abs_pseudo_raps.size() + 1, std::vector<double>(cuts.size() + 1, 0));
+        }
+
+        // n tracks are detected for cuts from index first_cut to the next
+        // track's first cut, as a track is detected when |eta| < cut
+        std::size_t first_cut = 0;
+        for (std::size_t n = 0; n < abs_pseudo_raps.size(); n++) {
+            const std::size_t next_first_cut = std::upper_bound(cuts.begin(), cuts.end(), 
+                                                                abs_pseudo_raps[n]) - cuts.begin();
+            detected_diffs[n][first_cut] += 1;
+            detected_diffs[n][next_first_cut] -= 1;
+            first_cut = next_first_cut;
+        }
+        detected_diffs[abs_pseudo_raps.size()][first_cut] += 1;
+        full_diffs[first_cut] += 1;
+    }
+
+    void Merge(const AcceptanceScanner& other) {
+        if (detected_diffs.size() < other.detected_diffs.size()) {
+            detected_diffs.resize(other.detected_diffs.size(), std::vector<double>(cuts.size() + 1, 0));
+        }
+        for (std::size_t n = 0; n < other.detected_diffs.size(); n++) {
+            for (std::size_t k = 0; k <= cuts.size(); k++) {
+                detected_diffs[n][k] += other.detected_diffs[n][k];
+            }
+        }
+        for (std::size_t k = 0; k <= cuts.size(); k++) {
+            full_diffs[k] += other.full_diffs[k];
+        }
+    }
+
+    // Returns counts, as prefix sums of the difference arrays
+    AcceptanceScan Scan() const {
+        AcceptanceScan scan;
+        scan.detected_counts.assign(detected_diffs.size(), std::vector<double>(cuts.size(), 0));
+        scan.full_detection_counts.assign(cuts.size(), 0);
+        for (std::size_t n = 0; n < detected_diffs.size(); n++) {
+            double count = 0;
+            for (std::size_t k = 0; k < cuts.size(); k++) {
+                count += detected_diffs[n][k];
+                scan.detected_counts[n][k] = count;
+            }
+        }
+        double full_count = 0;
+        for (std::size_t k = 0; k < cuts.size(); k++) {
+            full_count += full_diffs[k];
+            scan.full_detection_counts[k] = full_count;
+        }
+        return scan;
+    }
+
+    private:
+    std::vector<double> abs_pseudo_raps;
+};
+
+// Returns acceptance scan of events over the ascending list of cuts, 
+// with one scanner per thread which are merged afterwards
+template <typename Scalar>
+AcceptanceScan ScanPseudoRapAcceptance(const std::vector<BasicEvent<Scalar>>& events, 
+                                       const std::vector<double>& cuts) {
+    const int n_threads = NumThreads();
+    std::vector<AcceptanceScanner> scanners(n_threads, AcceptanceScanner(cuts));
+    ParallelForChunks(events.size(), n_threads, 
+        [&](std::size_t begin, std::size_t end, int thread_index) {
+            for (std::size_t i = begin; i < end; i++) {
+                scanners[thread_index].Add(events[i].pseudo_raps);
+            }
+        });
+    for (int t = 1; t < n_threads; t++) {
+        scanners[0].Merge(scanners[t]);
+    }
+    return scanners[0].Scan();
+}
+
+// Returns FNV-1a hash of bytes, continuing from hash
+std::uint64_t Fnv1aHash(const char* bytes, const std::size_t& n_bytes, 
+                        std::uint64_t hash = 14695981039346656037ULL) {
+    for (std::size_t i = 0; i < n_bytes; i++) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Returns result cache key of an analysis, from the contents of the result file,
+// the starlyze version, the precision of Real and the analysis configuration 
+// (macro, binning, cuts). Returns empty key for standard input, which can not be 
+// hashed without reading it, and for result files which can not be opened.
+std::string ResultCacheKey(const std::string& result_file_path, 
+                           const std::string& analysis_config) {
+    if (result_file_path == "-") return std::string("");
+
+    std::ifstream result_file(result_file_path, std::ios::binary);
+    if (!result_file) return std::string("");
+
+    std::vector<char> buffer(1 << 20);
+    std::uint64_t hash = Fnv1aHash(nullptr, 0);
+    while (result_file.read(buffer.data(), buffer.size()) || result_file.gcount() > 0) {
+        hash = Fnv1aHash(buffer.data(), result_file.gcount(), hash);
+    }
+    const std::string precision = (sizeof(Real) == sizeof(float)) ? "float" : "double";
+    hash = Fnv1aHash(kSTARLYZE_VERSION.data(), kSTARLYZE_VERSION.size(), hash);
+    hash = Fnv1aHash(precision.data(), precision.size(), hash);
+    hash = Fnv1aHash(analysis_config.data(), analysis_config.size(), hash);
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+// Finished histograms and summary numbers of an analysis. 
+// All histograms share the same bin edges.
+struct CachedResult {
+    std::string base_file_name;
+    std::string title;
+    int n_events = 0;
+    std::vector<double> bin_edges;
+    std::map<std::string, std::vector<double>> bin_contents;
+    std::map<std::string, double> summary;
+};
+
+// Returns false if there is no cached result for key, or if the cached result
+// is malformed or lacks any of the histograms in histogram_names. 
+// Then cached is left unchanged.
+bool LoadCachedResult(const std::string& cache_key, CachedResult& cached,
+                      const std::vector<std::string>& histogram_names = {"hist"}) {
+    if (cache_key.empty()) return false;
+    std::ifstream cache_file(kRESULT_CACHE_DIR + "/" + cache_key + ".txt");
+    if (!cache_file) return false;
+
+    CachedResult loaded;
+    std::string line, name;
+    std::size_t n_values;
+    while (std::getline(cache_file, line)) {
+        std::istringstream line_stream(line);
+        line_stream >> name;
+        if (name == "base_file_name") {
+            line_stream >> loaded.base_file_name;
+        } else if (name == "title") {
+            std::getline(line_stream >> std::ws, loaded.title);
+        } else if (name == "n_events") {
+            line_stream >> loaded.n_events;
+        } else if (name == "bin_edges") {
+            line_stream >> n_values;
+            loaded.bin_edges.resize(n_values);
+            for (double& value : loaded.bin_edges) line_stream >> value;
+        } else if (name == "bin_contents") {
+            line_stream >> name >> n_values;
+            std::vector<double>& contents = loaded.bin_contents[name];
+            contents.resize(n_values);
+            for (double& value : contents) line_stream >> value;
+        } else if (name == "summary") {
+            line_stream >> name;
+            line_stream >> loaded.summary[name];
+        }
+        if (line_stream.fail()) return false;
+    }
+
+    // Every histogram needs one content per bin
+    if (loaded.bin_edges.size() < 2) return false;
+    for (const std::string& histogram_name : histogram_names) {
+        if (loaded.bin_contents.count(histogram_name) == 0) return false;
+    }
+    for (const auto& contents : loaded.bin_contents) {
+        if (contents.second.size() != loaded.bin_edges.size() - 1) return false;
+    }
+
+    cached = loaded;
+    return true;
+}
+
+void StoreCachedResult(const std::string& cache_key, const CachedResult& cached) {
+    if (cache_key.empty()) return;
+    std::filesystem::create_directories(kRESULT_CACHE_DIR);
+
+    // Write to temporary file first, so an interrupted run leaves no partial entry
+    const std::string cache_file_path = kRESULT_CACHE_DIR + "/" + cache_key + ".txt";
+    std::ofstream cache_file(cache_file_path + ".tmp");
+    cache_file << std::setprecision(17);
+    cache_file << "base_file_name " << cached.base_file_name << "\n"
+               << "title " << cached.title << "\n"
+               << "n_events " << cached.n_events << "\n"
+               << "bin_edges " << cached.bin_edges.size();
+    for (const double& value : cached.bin_edges) cache_file << " " << value;
+    cache_file << "\n";
+    for (const auto& contents : cached.bin_contents) {
+        cache_file << "bin_contents " << contents.first << " " << contents.second.size();
+        for (const double& value : contents.second) cache_file << " " << value;
+        cache_file << "\n";
+    }
+    for (const auto& value : cached.summary) {
+        cache_file << "summary " << value.first << " " << value.second << "\n";
+    }
+    cache_file.close();
+    std::filesystem::rename(cache_file_path + ".tmp", cache_file_path);
 }
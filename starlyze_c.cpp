@@ -0,0 +1,130 @@
+// Local Includes
+#include "starlyze.cpp"
+#include "starlyze_c.h"
+
+// Header information and columns of a result. Columns are filled once when
+// opening, and never resized afterwards, so their data pointers stay valid.
+struct starlyze_result {
+    int decay_id;
+    int rnd_seed;
+    int64_t n_events;
+    double sqrt_s_NN;
+    std::string decay_repr_str;
+    std::vector<double> columns[STARLYZE_N_COLUMNS];
+    std::vector<int64_t> track_offsets, pair_offsets;
+};
+
+extern "C" {
+
+const char* starlyze_version(void) {
+    return kSTARLYZE_VERSION.c_str();
+}
+
+starlyze_result* starlyze_open(const char* result_file_path, uint32_t seed) {
+    if (result_file_path == nullptr) return nullptr;
+
+    // Exceptions must not cross the C ABI
+    starlyze_result* result = new starlyze_result;
+    try {
+        // Columns are always double, independent of the precision of the macros.
+        // Events are appended to the columns as they are streamed, and never stored.
+        // Shuffle with an engine of this handle, not the shared kRNG.
+        std::vector<double>* columns = result->columns;
+        result->track_offsets.push_back(0);
+        result->pair_offsets.push_back(0);
+        std::default_random_engine rng(seed);
+        const BasicSimulationResult<double> results = StreamSimulationResults<double>(result_file_path, 
+            [&](BasicEvent<double>& event) {
+                columns[STARLYZE_EVENT_M_INV].push_back(event.m_inv);
+                columns[STARLYZE_EVENT_P_TRANS].push_back(event.p_trans);
+                for (const BasicTrack<double>& track : event.tracks) {
+                    columns[STARLYZE_TRACK_E].push_back(track.E());
+                    columns[STARLYZE_TRACK_PX].push_back(track.px);
+                    columns[STARLYZE_TRACK_PY].push_back(track.py);
+                    columns[STARLYZE_TRACK_PZ].push_back(track.pz);
+                    columns[STARLYZE_TRACK_PSEUDO_RAP].push_back(track.pseudo_rap);
+                }
+                for (const double& m_inv_pair : event.m_inv_pairs) {
+                    columns[STARLYZE_PAIR_M_INV].push_back(m_inv_pair);
+                }
+                result->track_offsets.push_back(columns[STARLYZE_TRACK_E].size());
+                result->pair_offsets.push_back(columns[STARLYZE_PAIR_M_INV].size());
+            }, true, false, rng);
+
+        // Input without any events is not a STARlight result
+        if (results.n_events == 0) {
+            delete result;
+            return nullptr;
+        }
+
+        result->decay_id = results.decay_id;
+        result->rnd_seed = results.rnd_seed;
+        result->n_events = results.n_events;
+        result->sqrt_s_NN = results.sqrt_s_NN;
+        result->decay_repr_str = results.decay_repr_str;
+
+        return result;
+    } catch (...) {
+        delete result;
+        return nullptr;
+    }
+}
+
+void starlyze_close(starlyze_result* result) {
+    delete result;
+}
+
+double starlyze_sqrt_s_nn(const starlyze_result* result) {
+    if (result == nullptr) return 0;
+    return result->sqrt_s_NN;
+}
+
+int starlyze_decay_id(const starlyze_result* result) {
+    if (result == nullptr) return 0;
+    return result->decay_id;
+}
+
+int starlyze_rnd_seed(const starlyze_result* result) {
+    if (result == nullptr) return 0;
+    return result->rnd_seed;
+}
+
+int64_t starlyze_n_events(const starlyze_result* result) {
+    if (result == nullptr) return 0;
+    return result->n_events;
+}
+
+const char* starlyze_decay_repr(const starlyze_result* result) {
+    if (result == nullptr) return nullptr;
+    return result->decay_repr_str.c_str();
+}
+
+const double* starlyze_column_data(const starlyze_result* result,
+                                   starlyze_column column, size_t* length) {
+    if (result == nullptr || column < 0 || column >= STARLYZE_N_COLUMNS) {
+        if (length != nullptr) *length = 0;
+        return nullptr;
+    }
+    if (length != nullptr) *length = result->columns[column].size();
+    return result->columns[column].data();
+}
+
+const int64_t* starlyze_track_offsets(const starlyze_result* result, size_t* length) {
+    if (result == nullptr) {
+        if (length != nullptr) *length = 0;
+        return nullptr;
+    }
+    if (length != nullptr) *length = result->track_offsets.size();
+    return result->track_offsets.data();
+}
+
+const int64_t* starlyze_pair_offsets(const starlyze_result* result, size_t* length) {
+    if (result == nullptr) {
+        if (length != nullptr) *length = 0;
+        return nullptr;
+    }
+    if (length != nullptr) *length = result->pair_offsets.size();
+    return result->pair_offsets.data();
+}
+
+}
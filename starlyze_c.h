@@ -0,0 +1,85 @@
+/* C API of starlyze, for use from other languages (Python, Julia, ...).
+ *
+ * Build the shared library with:
+ *     g++ -std=c++17 -O2 -shared -fPIC -pthread -fvisibility=hidden \
+ *         -Wl,--version-script=starlyze_c.map -o libstarlyze.so starlyze_c.cpp
+ *
+ * Only the starlyze_* functions are exported. -fvisibility=hidden hides the
+ * analysis core, and the version script also hides the C++ standard library
+ * templates it instantiates.
+ *
+ * A handle owns all columns of one STARlight result. Column pointers stay
+ * valid, and their contents unchanged, until the handle is closed, so they
+ * can be wrapped as numpy/Julia arrays without copying.
+ *
+ * Tracks and pairs of event i are the elements [offsets[i], offsets[i+1])
+ * of the track and pair columns.
+ *
+ * Tracks of each event are shuffled, as in the macros, with an engine owned by
+ * the handle and seeded with seed. Columns of a file therefore only depend on
+ * the seed, not on other handles, and handles can be opened concurrently.
+ *
+ * Functions taking a handle return 0 or NULL when given a NULL handle.
+ */
+#ifndef STARLYZE_C_H
+#define STARLYZE_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define STARLYZE_API __attribute__((visibility("default")))
+#else
+#define STARLYZE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct starlyze_result starlyze_result;
+
+/* Values are part of the ABI, only append new columns */
+typedef enum {
+    STARLYZE_EVENT_M_INV = 0,       /* Invariant mass of all tracks [GeV/c^2] */
+    STARLYZE_EVENT_P_TRANS = 1,     /* Transverse momentum of all tracks [GeV/c] */
+    STARLYZE_TRACK_E = 2,           /* [GeV] */
+    STARLYZE_TRACK_PX = 3,          /* [GeV/c] */
+    STARLYZE_TRACK_PY = 4,          /* [GeV/c] */
+    STARLYZE_TRACK_PZ = 5,          /* [GeV/c] */
+    STARLYZE_TRACK_PSEUDO_RAP = 6,
+    STARLYZE_PAIR_M_INV = 7,        /* Invariant mass of track pairs [GeV/c^2] */
+    STARLYZE_N_COLUMNS = 8
+} starlyze_column;
+
+/* Version of starlyze, as used in result cache keys */
+STARLYZE_API const char* starlyze_version(void);
+
+/* Reads STARlight result file, or standard input if path is "-", shuffling 
+ * tracks with an engine seeded with seed. Returns NULL if the path is NULL, 
+ * if the file can not be opened or read, if a line can not be parsed, or if 
+ * the file holds no events. */
+STARLYZE_API starlyze_result* starlyze_open(const char* result_file_path, uint32_t seed);
+STARLYZE_API void starlyze_close(starlyze_result* result);
+
+/* Header information */
+STARLYZE_API double starlyze_sqrt_s_nn(const starlyze_result* result);
+STARLYZE_API int starlyze_decay_id(const starlyze_result* result);
+STARLYZE_API int starlyze_rnd_seed(const starlyze_result* result);
+STARLYZE_API int64_t starlyze_n_events(const starlyze_result* result);
+STARLYZE_API const char* starlyze_decay_repr(const starlyze_result* result);
+
+/* Contiguous column of doubles. Writes its length to *length, if not NULL.
+ * Returns NULL for unknown columns. */
+STARLYZE_API const double* starlyze_column_data(const starlyze_result* result,
+                                                starlyze_column column, size_t* length);
+
+/* Event offsets into the track and pair columns, with n_events + 1 elements */
+STARLYZE_API const int64_t* starlyze_track_offsets(const starlyze_result* result, size_t* length);
+STARLYZE_API const int64_t* starlyze_pair_offsets(const starlyze_result* result, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STARLYZE_C_H */